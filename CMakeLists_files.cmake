@@ -70,9 +70,15 @@ list (APPEND TEST_SOURCE_FILES
 	tests/test_autodiffhelpers.cpp
 	tests/test_autodiffmatrix.cpp
 	tests/test_block.cpp
+	tests/test_indexedrowsum.cpp
 	tests/test_boprops_ad.cpp
 	tests/test_rateconverter.cpp
 	tests/test_span.cpp
+	tests/test_pvtpointcache.cpp
+	tests/test_compiledtablelinear.cpp
+	tests/test_localwellequations.cpp
+	tests/test_reorderedsolve.cpp
+	tests/test_segmenttreesolver.cpp
 	tests/test_syntax.cpp
 	tests/test_scalar_mult.cpp
 	tests/test_transmissibilitymultipliers.cpp
@@ -149,6 +155,7 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/autodiff/FlowMainSolvent.hpp
 	opm/autodiff/GeoProps.hpp
 	opm/autodiff/GridHelpers.hpp
+	opm/autodiff/IndexedRowSum.hpp
 	opm/autodiff/GridInit.hpp
 	opm/autodiff/ImpesTPFAAD.hpp
 	opm/autodiff/moduleVersion.hpp
@@ -160,13 +167,18 @@ list (APPEND PUBLIC_HEADER_FILES
 	opm/autodiff/NonlinearSolver.hpp
 	opm/autodiff/NonlinearSolver_impl.hpp
 	opm/autodiff/LinearisedBlackoilResidual.hpp
+	opm/autodiff/LocalWellEquations.hpp
 	opm/autodiff/ParallelDebugOutput.hpp
 	opm/autodiff/ParallelOverlappingILU0.hpp
 	opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp
+	opm/autodiff/PvtPointCache.hpp
+	opm/autodiff/CompiledTableLinear.hpp
 	opm/autodiff/RateConverter.hpp
 	opm/autodiff/RedistributeDataHandles.hpp
+	opm/autodiff/SegmentTreeSolver.hpp
 	opm/autodiff/SimulatorBase.hpp
 	opm/autodiff/SimulatorBase_impl.hpp
+	opm/autodiff/StepStartHistory.hpp
 	opm/autodiff/SimulatorFullyImplicitBlackoil.hpp
 	opm/autodiff/SimulatorFullyImplicitBlackoilSolvent.hpp
 	opm/autodiff/SimulatorFullyImplicitBlackoilSolvent_impl.hpp
@@ -330,7 +330,7 @@ namespace Opm
             assert(numBlocks() == rhs.numBlocks());
             M D1(val_.matrix().asDiagonal());
             M D2(rhs.val_.matrix().asDiagonal());
-#pragma omp parallel for schedule(dynamic)
+#pragma omp parallel for schedule(dynamic) if(detail::numPartitions(size()) == 1)
             for (int block = 0; block < num_blocks; ++block) {
                 assert(jac_[block].rows() == rhs.jac_[block].rows());
                 assert(jac_[block].cols() == rhs.jac_[block].cols());
@@ -368,7 +368,7 @@ namespace Opm
             M D1(val_.matrix().asDiagonal());
             M D2(rhs.val_.matrix().asDiagonal());
             M D3((1.0/(rhs.val_*rhs.val_)).matrix().asDiagonal());
-#pragma omp parallel for schedule(dynamic)
+#pragma omp parallel for schedule(dynamic) if(detail::numPartitions(size()) == 1)
             for (int block = 0; block < num_blocks; ++block) {
                 assert(jac_[block].rows() == rhs.jac_[block].rows());
                 assert(jac_[block].cols() == rhs.jac_[block].cols());
@@ -493,7 +493,7 @@ namespace Opm
         int num_blocks = rhs.numBlocks();
         std::vector<typename AutoDiffBlock<Scalar>::M> jac(num_blocks);
         assert(lhs.cols() == rhs.value().rows());
-#pragma omp parallel for schedule(dynamic)
+#pragma omp parallel for schedule(dynamic) if(detail::numPartitions(rhs.size()) == 1)
         for (int block = 0; block < num_blocks; ++block) {
             fastSparseProduct(lhs, rhs.derivative()[block], jac[block]);
         }
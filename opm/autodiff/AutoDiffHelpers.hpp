@@ -188,31 +188,50 @@ struct HelperOps
             int num_connections = nif + num_nnc;
             assert(num_connections == ifaceflux.size());
 
-            // Define selector structure.
-            typedef typename Eigen::Triplet<Scalar> Triplet;
-            std::vector<Triplet> s;  s.reserve(num_connections);
+            // Store the cells of each connection, so that the selector
+            // can be updated without the grid.
+            cell1_.resize(num_connections);
+            cell2_.resize(num_connections);
             for (IFIndex iface = 0; iface < nif; ++iface) {
                 const int f  = h.internal_faces[iface];
-                const int c1 = face_cells(f,0);
-                const int c2 = face_cells(f,1);
-
-                assert ((c1 >= 0) && (c2 >= 0));
+                cell1_[iface] = face_cells(f,0);
+                cell2_[iface] = face_cells(f,1);
 
-                // Select upwind cell.
-                const int c = (ifaceflux[iface] >= 0) ? c1 : c2;
+                assert ((cell1_[iface] >= 0) && (cell2_[iface] >= 0));
+            }
+            for (int i = 0; i < num_nnc; ++i) {
+                cell1_[i+nif] = h.nnc_cells(i,0);
+                cell2_[i+nif] = h.nnc_cells(i,1);
+            }
+            num_cells_ = numCells(g);
 
-                s.push_back(Triplet(iface, c, Scalar(1)));
+            upwind_.resize(num_connections);
+            for (int conn = 0; conn < num_connections; ++conn) {
+                upwind_[conn] = (ifaceflux[conn] >= 0) ? cell1_[conn] : cell2_[conn];
             }
-            if (num_nnc > 0) {
-                for (int i = 0; i < num_nnc; ++i) {
-                    const int c = (ifaceflux[i+nif] >= 0) ? h.nnc_cells(i,0) : h.nnc_cells(i,1);
-                    s.push_back(Triplet(i+nif,c,Scalar(1)));
+            buildSelector();
+        }
+
+        /// Update the selector for new connection fluxes.
+        /// The selector is only rebuilt if the upwind direction
+        /// changed for at least one connection.
+        /// \return true if the selector was rebuilt.
+        bool update(const typename ADB::V& ifaceflux)
+        {
+            const int num_connections = upwind_.size();
+            assert(num_connections == ifaceflux.size());
+            bool changed = false;
+            for (int conn = 0; conn < num_connections; ++conn) {
+                const int c = (ifaceflux[conn] >= 0) ? cell1_[conn] : cell2_[conn];
+                if (c != upwind_[conn]) {
+                    upwind_[conn] = c;
+                    changed = true;
                 }
             }
-
-            // Assemble explicit selector operator.
-            select_.resize(num_connections, numCells(g));
-            select_.setFromTriplets(s.begin(), s.end());
+            if (changed) {
+                buildSelector();
+            }
+            return changed;
         }
 
         /// Apply selector to multiple per-cell quantities.
@@ -245,6 +264,24 @@ struct HelperOps
         }
 
     private:
+        // Assemble the explicit selector operator from upwind_. It has
+        // exactly one entry per row, so the row-major form is written
+        // directly and converted, instead of sorting triplets.
+        void buildSelector()
+        {
+            const int num_connections = upwind_.size();
+            Eigen::SparseMatrix<double, Eigen::RowMajor> s(num_connections, num_cells_);
+            s.reserve(Eigen::VectorXi::Constant(num_connections, 1));
+            for (int conn = 0; conn < num_connections; ++conn) {
+                s.insert(conn, upwind_[conn]) = Scalar(1);
+            }
+            select_ = s;
+        }
+
+        std::vector<int> cell1_;
+        std::vector<int> cell2_;
+        std::vector<int> upwind_;
+        int num_cells_;
         Eigen::SparseMatrix<double> select_;
     };
 
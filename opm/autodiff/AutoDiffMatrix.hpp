@@ -604,6 +604,19 @@ namespace Opm
 
 
 
+        /**
+         * Returns true if the matrix is stored as an identity or diagonal
+         * matrix, so that coeff(i, i) gives all its entries without
+         * converting it to a sparse matrix.
+         */
+        bool isDiagonal() const
+        {
+            return type_ == Identity || type_ == Diagonal;
+        }
+
+
+
+
         /**
          * Returns element (row, col) in the matrix
          */
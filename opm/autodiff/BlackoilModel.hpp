@@ -74,6 +74,36 @@ namespace Opm {
                    eclState, has_disgas, has_vapoil, terminal_output)
         {
         }
+
+        /// Called once before each time step.
+        /// If requested by the model parameters, the initial guess is
+        /// extrapolated from the two last accepted states.
+        /// \param[in] dt                     time step size
+        /// \param[in, out] reservoir_state   reservoir state variables
+        /// \param[in, out] well_state        well state variables
+        void prepareStep(const double dt,
+                         typename Base::ReservoirState& reservoir_state,
+                         typename Base::WellState& well_state)
+        {
+            Base::prepareStep(dt, reservoir_state, well_state);
+            if (Base::param_.extrapolate_initial_guess_) {
+                Base::extrapolateInitialGuess(dt, reservoir_state, well_state);
+            }
+        }
+
+        /// Called once after each successful time step.
+        /// \param[in] dt                     time step size
+        /// \param[in, out] reservoir_state   reservoir state variables
+        /// \param[in, out] well_state        well state variables
+        void afterStep(const double dt,
+                       typename Base::ReservoirState& reservoir_state,
+                       typename Base::WellState& well_state)
+        {
+            Base::afterStep(dt, reservoir_state, well_state);
+            if (Base::param_.extrapolate_initial_guess_) {
+                Base::acceptStepStartVariables();
+            }
+        }
     };
 
 
@@ -27,14 +27,18 @@
 
 #include <opm/autodiff/AutoDiffBlock.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
+#include <opm/autodiff/IndexedRowSum.hpp>
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/LinearisedBlackoilResidual.hpp>
 #include <opm/autodiff/NewtonIterationBlackoilInterface.hpp>
 #include <opm/autodiff/BlackoilModelEnums.hpp>
+#include <opm/autodiff/LocalWellEquations.hpp>
+#include <opm/autodiff/StepStartHistory.hpp>
 #include <opm/autodiff/VFPProperties.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/NNC.hpp>
 
 #include <array>
+#include <memory>
 
 struct Wells;
 
@@ -158,7 +162,16 @@ namespace Opm {
         ///                                   of the grid passed in the constructor.
         void setThresholdPressures(const std::vector<double>& threshold_pressures_by_face);
 
+        /// \brief Set the history used to extrapolate the initial guess
+        /// of a time step. Passing the same history to the models of
+        /// consecutive report steps lets the extrapolation use the
+        /// time steps of earlier models.
+        void setStepStartHistory(std::shared_ptr<StepStartHistory> history);
+
         /// Called once before each time step.
+        /// If the previous call to step() failed, the caller is expected
+        /// to pass the same state as in that attempt, and the start-of-step
+        /// quantities computed then are reused.
         /// \param[in] dt                     time step size
         /// \param[in, out] reservoir_state   reservoir state variables
         /// \param[in, out] well_state        well state variables
@@ -182,8 +195,9 @@ namespace Opm {
                                            ReservoirState& reservoir_state,
                                            WellState& well_state);
 
-        /// Called once after each time step.
-        /// In this class, this function does nothing.
+        /// Called once after each successful time step.
+        /// In this class, this function only invalidates the cached
+        /// start-of-step quantities.
         /// \param[in] dt                     time step size
         /// \param[in, out] reservoir_state   reservoir state variables
         /// \param[in, out] well_state        well state variables
@@ -265,15 +279,29 @@ namespace Opm {
             std::vector<ADB> accum; // Accumulations
             ADB              mflux; // Mass flux (surface conditions)
             ADB              b;     // Reciprocal FVF
+            ADB              mu;    // Viscosity, computed together with b
             ADB              dh;    // Pressure drop across int. interfaces
             ADB              mob;   // Phase mobility (per cell)
         };
 
         struct WellOps {
-            WellOps(const Wells* wells);
+            WellOps(const Wells* wells, const int num_cells);
             Eigen::SparseMatrix<double> w2p;              // well -> perf (scatter)
             Eigen::SparseMatrix<double> p2w;              // perf -> well (gather)
             std::vector<int> well_cells;                  // the set of perforated cells
+            IndexedRowSum c2p;                            // cell -> perf (gather from well_cells)
+        };
+
+        // Geological quantities of the connections in assembly order
+        // (internal faces followed by non-neighbouring connections),
+        // kept until the derived geology is updated.
+        struct GeometryCache {
+            GeometryCache();
+            int       revision;   // DerivedGeology::revision() of the contents
+            V         trans_all;  // Transmissibilities
+            V         gdz;        // Gravity times depth differences
+            double    pore_volume; // Total pore volume of the global grid
+            double    pvdt_dt;    // Time step of pvdt_, zero if not computed
         };
 
         // ---------  Data members  ---------
@@ -301,12 +329,18 @@ namespace Opm {
         V threshold_pressures_by_connection_;
 
         std::vector<ReservoirResidualQuant> rq_;
+        // Upwind selectors of the previous assembly, one per entry of rq_.
+        std::vector<std::unique_ptr<UpwindSelector<double> > > upwind_;
         std::vector<PhasePresence> phaseCondition_;
         V isRs_;
         V isRv_;
         V isSg_;
         V well_perforation_densities_; //Density of each well perforation
         V well_perforation_pressure_diffs_; // Diff to bhp for each well perforation.
+        // Depths and surface densities (P values per perforation) of the
+        // perforated cells, which do not change during the simulation.
+        std::vector<double> well_perforation_depths_;
+        std::vector<double> well_perforation_surface_densities_;
 
         LinearisedBlackoilResidual residual_;
 
@@ -314,14 +348,38 @@ namespace Opm {
         bool terminal_output_;
         /// \brief The number of cells of the global grid.
         int global_nc_;
+        /// \brief The cells owned by this process in a parallel run,
+        ///        i.e. all cells except the overlap cells.
+        std::vector<int> owned_cells_;
 
         std::vector<int>         primalVariable_;
         V pvdt_;
+        GeometryCache geom_cache_;
         std::vector<std::string> material_name_;
         std::vector<std::vector<double>> residual_norms_history_;
         double current_relaxation_;
         V dx_old_;
 
+        // Start-of-step variables for extrapolating the initial guess,
+        // possibly shared with earlier models, see setStepStartHistory().
+        std::shared_ptr<StepStartHistory> step_history_;
+        // True if accumulation terms and well connection pressures of the
+        // start of the step have been computed before the first assembly.
+        bool start_quantities_computed_;
+        // True if the start-of-step quantities are kept from an earlier,
+        // failed, attempt at the current step. The accumulation terms
+        // rq_[].accum[0] are never modified by the iterations, only the
+        // well connection pressures need a copy.
+        bool start_quantities_cached_;
+        V cached_perforation_densities_;
+        V cached_perforation_pressure_diffs_;
+        // True if the mass balance and CNV criteria were met in the last
+        // call to getConvergence(), regardless of the well equations.
+        bool reservoir_converged_;
+        // True if the last nonlinear iteration only solved the well
+        // equations. Two such iterations are never done in a row.
+        bool last_iteration_well_only_;
+
         // ---------  Protected methods  ---------
 
         /// Access the most-derived class used for
@@ -387,6 +445,12 @@ namespace Opm {
         void computeWellConnectionPressures(const SolutionState& state,
                                             const WellState& xw);
 
+        /// Compute the accumulation terms and well connection pressures of
+        /// the start of the step, and keep them for a possible restart of
+        /// the step from the same state.
+        void computeStartOfStepQuantities(const SolutionState& state0,
+                                          const WellState& xw);
+
         void
         assembleMassBalanceEq(const SolutionState& state);
 
@@ -400,6 +464,34 @@ namespace Opm {
                     SolutionState& state,
                     WellState& well_state);
 
+        /// Solve the well equations well by well, in parallel, with the
+        /// reservoir state fixed. Each well has a small dense system for
+        /// its phase rates and bhp, and is iterated until it converges.
+        /// Only wells under bhp or rate control are supported.
+        /// \return true if all wells converged.
+        bool
+        solveWellEqLocal(const std::vector<ADB>& mob_perfcells,
+                         const std::vector<ADB>& b_perfcells,
+                         SolutionState& state,
+                         WellState& well_state);
+
+        /// The equations of well w with the reservoir state fixed.
+        LocalWellEquations
+        localWellEquations(const int w,
+                           const std::vector<ADB>& mob_perfcells,
+                           const std::vector<ADB>& b_perfcells,
+                           const SolutionState& state,
+                           const WellState& well_state) const;
+
+        /// True if the well equations can be solved by solveWellEqLocal()
+        /// on all processes.
+        bool canSolveWellEqLocal() const;
+
+        /// Solve the linearised well equations of solveWellEq(), with
+        /// the well unknowns collapsed into a single Jacobian block.
+        /// \return the Newton update, to be subtracted from the well state.
+        V solveWellLinearSystem(const ADB& total_residual) const;
+
         void
         computeWellFlux(const SolutionState& state,
                         const std::vector<ADB>& mob_perfcells,
@@ -433,6 +525,50 @@ namespace Opm {
 
         bool getWellConvergence(const int iteration);
 
+        /// Do Newton iterations restricted to the cells that violate the
+        /// local (CNV) convergence criterion, extended by a number of
+        /// layers of neighbouring cells. The well variables and all other
+        /// cells are kept fixed. Requires a current linearisation, and
+        /// leaves the linearisation of the resulting state in residual_.
+        /// \return the number of local iterations done.
+        int localNonlinearIterations(const double dt,
+                                     ReservoirState& reservoir_state,
+                                     WellState& well_state);
+
+        /// Solve the well equations with the reservoir state fixed, for
+        /// use when only the wells are unconverged. Requires a current
+        /// linearisation. The well state is only changed on success.
+        /// \return true if the well equations converged.
+        bool wellOnlyIteration(const ReservoirState& reservoir_state,
+                               WellState& well_state);
+
+        /// Offsets of the primary variable blocks in the nonlinear update,
+        /// with one entry more than the number of blocks.
+        std::vector<int> primaryVariableOffsets() const;
+
+        /// Sequential implicit update: solve for pressure and well
+        /// variables with the transported quantities fixed, then do
+        /// transport iterations with pressure and wells fixed.
+        void sequentialUpdate(const double dt,
+                              ReservoirState& reservoir_state,
+                              WellState& well_state);
+
+        /// Assemble the mass balance equations for a transport step of
+        /// the sequential implicit scheme. Pressure and the well
+        /// variables are kept fixed, so the well controls, the well
+        /// connection pressures and the well equations are not updated.
+        void assembleTransportEq(const ReservoirState& reservoir_state,
+                                 WellState& well_state);
+
+        /// Pressure and well part of the nonlinear update. The pressure
+        /// equation is the sum of the mass balance equations weighted by
+        /// the inverse formation volume factors.
+        V solvePressureSystem() const;
+
+        /// Update of the transported quantities for fixed pressure and
+        /// wells, solved by reordering along the cell graph.
+        V solveTransportSystem() const;
+
         bool isVFPActive() const;
 
         std::vector<ADB>
@@ -461,6 +597,24 @@ namespace Opm {
 
         void applyThresholdPressures(ADB& dp);
 
+        /// Upwind selector for the phase at position pos of rq_ and the
+        /// given head differences. The selector of the previous call for
+        /// the same phase is reused if no connection changed direction.
+        const UpwindSelector<double>&
+        upwindSelector(const int pos, const V& dh);
+
+        /// Connection quantities of the current geology. They are
+        /// recomputed only after DerivedGeology::update(), so this must
+        /// be called outside of parallel regions.
+        const GeometryCache& geometryCache();
+
+        /// Update pvdt_ for the step length dt, unless it is already
+        /// computed for dt and the current geology.
+        void updatePoreVolumeOverDt(const double dt);
+
+        /// True if pore volumes and transmissibilities depend on pressure.
+        bool hasRockCompressibility() const;
+
         ADB
         fluidViscosity(const int               phase,
                        const ADB&              p    ,
@@ -477,6 +631,19 @@ namespace Opm {
                          const ADB&              rv   ,
                          const std::vector<PhasePresence>& cond) const;
 
+        /// Reciprocal FVF and viscosity of a phase, evaluated together.
+        /// Implementations that override fluidReciprocFVF() or
+        /// fluidViscosity() must override this method as well.
+        void
+        fluidReciprocFVFAndViscosity(const int               phase,
+                                     const ADB&              p    ,
+                                     const ADB&              temp ,
+                                     const ADB&              rs   ,
+                                     const ADB&              rv   ,
+                                     const std::vector<PhasePresence>& cond,
+                                     ADB&                    b    ,
+                                     ADB&                    mu   ) const;
+
         ADB
         fluidDensity(const int  phase,
                      const ADB& b,
@@ -526,6 +693,25 @@ namespace Opm {
         void
         updatePhaseCondFromPrimalVariable();
 
+        /// Replace the state by an extrapolation of the two last accepted
+        /// states, weighted by the ratio of the time step sizes. The
+        /// extrapolated update is limited by the same chopping as used in
+        /// updateState(). The start-of-step accumulation terms and well
+        /// connection pressures are computed from the unmodified state
+        /// before extrapolating.
+        /// \param[in]      dt                time step size
+        /// \param[in, out] reservoir_state   reservoir state variables
+        /// \param[in, out] well_state        well state variables
+        void
+        extrapolateInitialGuess(const double dt,
+                                ReservoirState& reservoir_state,
+                                WellState& well_state);
+
+        /// Remember the start-of-step variables of an accepted time step
+        /// as history for extrapolateInitialGuess().
+        void
+        acceptStepStartVariables();
+
         /// \brief Compute the reduction within the convergence check.
         /// \param[in] B     A matrix with MaxNumPhases columns and the same number rows
         ///                  as the number of cells of the grid. B.col(i) contains the values
@@ -31,6 +31,7 @@
 #include <opm/autodiff/GridHelpers.hpp>
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/GeoProps.hpp>
+#include <opm/autodiff/NewtonIterationUtilities.hpp>
 #include <opm/autodiff/WellDensitySegmented.hpp>
 #include <opm/autodiff/VFPProperties.hpp>
 #include <opm/autodiff/VFPProdProperties.hpp>
@@ -49,6 +50,7 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/common/data/SimulationDataContainer.hpp>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -166,7 +168,7 @@ namespace detail {
         , canph_ (detail::active2Canonical(fluid.phaseUsage()))
         , cells_ (detail::buildAllCells(Opm::AutoDiffGrid::numCells(grid)))
         , ops_   (grid, geo.nnc())
-        , wops_  (wells_)
+        , wops_  (wells_, Opm::AutoDiffGrid::numCells(grid))
         , has_disgas_(has_disgas)
         , has_vapoil_(has_vapoil)
         , param_( param )
@@ -184,6 +186,11 @@ namespace detail {
         , terminal_output_ (terminal_output)
         , material_name_{ "Water", "Oil", "Gas" }
         , current_relaxation_(1.0)
+        , step_history_(std::make_shared<StepStartHistory>())
+        , start_quantities_computed_(false)
+        , start_quantities_cached_(false)
+        , reservoir_converged_(false)
+        , last_iteration_well_only_(false)
     {
         assert(numMaterials() == 3); // Due to the material_name_ init above.
 #if HAVE_MPI
@@ -195,13 +202,24 @@ namespace detail {
                 // Only rank 0 does print to std::cout if terminal_output is enabled
                 terminal_output_ = (info.communicator().rank()==0);
             }
+            if ( param_.sequential_implicit_ ) {
+                // The pressure and transport systems are solved by direct
+                // solvers on the local cells, and the transport convergence
+                // check is not reduced over the processes.
+                OPM_THROW(std::logic_error, "Sequential implicit solution is not supported in parallel runs.");
+            }
             int local_number_of_wells = wells_ ? wells_->number_of_wells : 0;
             int global_number_of_wells = info.communicator().sum(local_number_of_wells);
             wells_active_ = ( wells_ && global_number_of_wells > 0 );
-            // Compute the global number of cells
+            // Find the cells owned by this process, and the global number of cells
             std::vector<int> v( Opm::AutoDiffGrid::numCells(grid_), 1);
-            global_nc_ = 0;
-            info.computeReduction(v, Opm::Reduction::makeGlobalSumFunctor<int>(), global_nc_);
+            const std::vector<double>& mask = info.updateOwnerMask(v);
+            for (int c = 0; c < int(v.size()); ++c) {
+                if (mask[c] > 0.0) {
+                    owned_cells_.push_back(c);
+                }
+            }
+            global_nc_ = info.communicator().sum(int(owned_cells_.size()));
         }else
 #endif
         {
@@ -221,10 +239,17 @@ namespace detail {
                 ReservoirState& reservoir_state,
                 WellState& /* well_state */)
     {
-        pvdt_ = geo_.poreVolume() / dt;
+        updatePoreVolumeOverDt(dt);
         if (active_[Gas]) {
             updatePrimalVariableFromState(reservoir_state);
         }
+        // A step restarted after a chop starts from the same state, so the
+        // start-of-step quantities of the failed attempt are still valid.
+        start_quantities_computed_ = start_quantities_cached_;
+        if (start_quantities_cached_) {
+            well_perforation_densities_ = cached_perforation_densities_;
+            well_perforation_pressure_diffs_ = cached_perforation_pressure_diffs_;
+        }
     }
 
 
@@ -247,15 +272,44 @@ namespace detail {
             residual_norms_history_.clear();
             current_relaxation_ = 1.0;
             dx_old_ = V::Zero(sizeNonLinear());
+            last_iteration_well_only_ = false;
         }
         asImpl().assemble(reservoir_state, well_state, iteration == 0);
         residual_norms_history_.push_back(asImpl().computeResidualNorms());
-        const bool converged = asImpl().getConvergence(dt, iteration);
+        bool converged = asImpl().getConvergence(dt, iteration);
+        if (!converged && iteration > 0 && param_.local_solve_max_iter_ > 0) {
+            // Try to resolve local nonconvergence before the next global solve.
+            if (asImpl().localNonlinearIterations(dt, reservoir_state, well_state) > 0) {
+                residual_norms_history_.back() = asImpl().computeResidualNorms();
+                converged = asImpl().getConvergence(dt, iteration);
+            }
+        }
+        const bool try_well_only = !converged && reservoir_converged_
+            && iteration >= nonlinear_solver.minIter() && !last_iteration_well_only_
+            && param_.well_only_iterations_ && numMaterials() == numPhases();
+        last_iteration_well_only_ = false;
+        if (try_well_only) {
+            // Only the wells are unconverged: solve the well equations
+            // with the reservoir fixed instead of doing a global solve.
+            // The next iteration's assembly checks that the reservoir
+            // is still converged with the new well rates.
+            if (asImpl().wellOnlyIteration(reservoir_state, well_state)) {
+                last_iteration_well_only_ = true;
+                const bool failed = false;
+                return IterationReport{ failed, converged, 0 };
+            }
+        }
         const bool must_solve = (iteration < nonlinear_solver.minIter()) || (!converged);
         if (must_solve) {
             // enable single precision for solvers when dt is smaller then 20 days
             residual_.singlePrecision = (unit::convert::to(dt, unit::day) < 20.) ;
 
+            if (param_.sequential_implicit_) {
+                asImpl().sequentialUpdate(dt, reservoir_state, well_state);
+                const bool failed = false;
+                return IterationReport{ failed, converged, 0 };
+            }
+
             // Compute the nonlinear update.
             V dx = asImpl().solveJacobianSystem();
 
@@ -286,6 +340,31 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    bool
+    BlackoilModelBase<Grid, Implementation>::
+    wellOnlyIteration(const ReservoirState& reservoir_state,
+                      WellState& well_state)
+    {
+        if ( ! wellsActive() ) {
+            return false;
+        }
+        // Reservoir properties are those of the current linearisation.
+        SolutionState state = asImpl().variableState(reservoir_state, well_state);
+        std::vector<ADB> mob_perfcells;
+        std::vector<ADB> b_perfcells;
+        asImpl().extractWellPerfProperties(mob_perfcells, b_perfcells);
+        const bool converged = asImpl().solveWellEq(mob_perfcells, b_perfcells, state, well_state);
+        if (converged && terminalOutputEnabled()) {
+            std::cout << " Reservoir converged: well equations solved separately." << std::endl;
+        }
+        return converged;
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     void
     BlackoilModelBase<Grid, Implementation>::
@@ -293,7 +372,8 @@ namespace detail {
               ReservoirState& /* reservoir_state */,
               WellState& /* well_state */)
     {
-        // Does nothing in this model.
+        // The next step starts from a new state.
+        start_quantities_cached_ = false;
     }
 
 
@@ -404,11 +484,24 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::
+    setStepStartHistory(std::shared_ptr<StepStartHistory> history)
+    {
+        step_history_ = std::move(history);
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     BlackoilModelBase<Grid, Implementation>::ReservoirResidualQuant::ReservoirResidualQuant()
         : accum(2, ADB::null())
         , mflux(   ADB::null())
         , b    (   ADB::null())
+        , mu   (   ADB::null())
         , dh   (   ADB::null())
         , mob  (   ADB::null())
     {
@@ -418,12 +511,25 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    BlackoilModelBase<Grid, Implementation>::GeometryCache::GeometryCache()
+        : revision(-1)
+        , pore_volume(0.0)
+        , pvdt_dt(0.0)
+    {
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     BlackoilModelBase<Grid, Implementation>::
-    WellOps::WellOps(const Wells* wells)
+    WellOps::WellOps(const Wells* wells, const int num_cells)
       : w2p(),
         p2w(),
-        well_cells()
+        well_cells(),
+        c2p()
     {
         if( wells )
         {
@@ -451,6 +557,7 @@ namespace detail {
 
             well_cells.assign(wells->well_cells, wells->well_cells + wells->well_connpos[wells->number_of_wells]);
         }
+        c2p = IndexedRowSum::gather(num_cells, well_cells);
     }
 
 
@@ -752,14 +859,22 @@ namespace detail {
 
         const std::vector<PhasePresence> cond = phaseCondition();
 
-        const ADB pv_mult = poroMult(press);
+        const bool rock_comp = hasRockCompressibility();
+        const ADB pv_mult = rock_comp ? poroMult(press) : ADB::null();
 
         const int maxnp = Opm::BlackoilPhases::MaxNumPhases;
         for (int phase = 0; phase < maxnp; ++phase) {
             if (active_[ phase ]) {
                 const int pos = pu.phase_pos[ phase ];
-                rq_[pos].b = asImpl().fluidReciprocFVF(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond);
-                rq_[pos].accum[aix] = pv_mult * rq_[pos].b * sat[pos];
+                if (aix == 1) {
+                    // The viscosity is needed for the fluxes of the current
+                    // state, and shares the table lookups with b.
+                    asImpl().fluidReciprocFVFAndViscosity(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond,
+                                                          rq_[pos].b, rq_[pos].mu);
+                } else {
+                    rq_[pos].b = asImpl().fluidReciprocFVF(phase, state.canonical_phase_pressures[phase], temp, rs, rv, cond);
+                }
+                rq_[pos].accum[aix] = rock_comp ? pv_mult * rq_[pos].b * sat[pos] : rq_[pos].b * sat[pos];
                 // OPM_AD_DUMP(rq_[pos].b);
                 // OPM_AD_DUMP(rq_[pos].accum[aix]);
             }
@@ -824,7 +939,7 @@ namespace detail {
         const std::vector<int>& well_cells = wops_.well_cells;
 
         // Use cell values for the temperature as the wells don't knows its temperature yet.
-        const ADB perf_temp = subset(state.temperature, well_cells);
+        const ADB perf_temp = wops_.c2p * state.temperature;
 
         // Compute b, rsmax, rvmax values for perforations.
         // Evaluate the properties using average well block pressures
@@ -844,16 +959,16 @@ namespace detail {
             b.col(pu.phase_pos[BlackoilPhases::Aqua]) = bw;
         }
         assert(active_[Oil]);
-        const V perf_so =  subset(state.saturation[pu.phase_pos[Oil]].value(), well_cells);
+        const V perf_so =  wops_.c2p * state.saturation[pu.phase_pos[Oil]].value();
         if (pu.phase_used[BlackoilPhases::Liquid]) {
-            const ADB perf_rs = subset(state.rs, well_cells);
+            const ADB perf_rs = wops_.c2p * state.rs;
             const V bo = fluid_.bOil(avg_press_ad, perf_temp, perf_rs, perf_cond, well_cells).value();
             b.col(pu.phase_pos[BlackoilPhases::Liquid]) = bo;
             const V rssat = fluidRsSat(avg_press, perf_so, well_cells);
             rsmax_perf.assign(rssat.data(), rssat.data() + nperf);
         }
         if (pu.phase_used[BlackoilPhases::Vapour]) {
-            const ADB perf_rv = subset(state.rv, well_cells);
+            const ADB perf_rv = wops_.c2p * state.rv;
             const V bg = fluid_.bGas(avg_press_ad, perf_temp, perf_rv, perf_cond, well_cells).value();
             b.col(pu.phase_pos[BlackoilPhases::Vapour]) = bg;
             const V rvsat = fluidRvSat(avg_press, perf_so, well_cells);
@@ -861,19 +976,22 @@ namespace detail {
         }
         // b is row major, so can just copy data.
         std::vector<double> b_perf(b.data(), b.data() + nperf * pu.num_phases);
-        // Extract well connection depths.
-        const V depth = cellCentroidsZToEigen(grid_);
-        const V pdepth = subset(depth, well_cells);
-        std::vector<double> perf_depth(pdepth.data(), pdepth.data() + nperf);
 
-        // Surface density.
-        // The compute density segment wants the surface densities as
-        // an np * number of wells cells array
-        V rho = superset(fluid_.surfaceDensity(0 , well_cells), Span(nperf, pu.num_phases, 0), nperf*pu.num_phases);
-        for (int phase = 1; phase < pu.num_phases; ++phase) {
-            rho += superset(fluid_.surfaceDensity(phase , well_cells), Span(nperf, pu.num_phases, phase), nperf*pu.num_phases);
+        if (int(well_perforation_depths_.size()) != nperf) {
+            // Extract well connection depths.
+            const V depth = cellCentroidsZToEigen(grid_);
+            const V pdepth = subset(depth, well_cells);
+            well_perforation_depths_.assign(pdepth.data(), pdepth.data() + nperf);
+
+            // Surface density.
+            // The compute density segment wants the surface densities as
+            // an np * number of wells cells array
+            V rho = superset(fluid_.surfaceDensity(0 , well_cells), Span(nperf, pu.num_phases, 0), nperf*pu.num_phases);
+            for (int phase = 1; phase < pu.num_phases; ++phase) {
+                rho += superset(fluid_.surfaceDensity(phase , well_cells), Span(nperf, pu.num_phases, phase), nperf*pu.num_phases);
+            }
+            well_perforation_surface_densities_.assign(rho.data(), rho.data() + nperf * pu.num_phases);
         }
-        std::vector<double> surf_dens_perf(rho.data(), rho.data() + nperf * pu.num_phases);
 
         // Gravity
         double grav = detail::getGravity(geo_.gravity(), dimensions(grid_));
@@ -882,12 +1000,12 @@ namespace detail {
         std::vector<double> cd =
                 WellDensitySegmented::computeConnectionDensities(
                         wells(), xw, fluid_.phaseUsage(),
-                        b_perf, rsmax_perf, rvmax_perf, surf_dens_perf);
+                        b_perf, rsmax_perf, rvmax_perf, well_perforation_surface_densities_);
 
         // 3. Compute pressure deltas
         std::vector<double> cdp =
                 WellDensitySegmented::computeConnectionPressureDelta(
-                        wells(), perf_depth, cd, grav);
+                        wells(), well_perforation_depths_, cd, grav);
 
         // 4. Store the results
         well_perforation_densities_ = Eigen::Map<const V>(cd.data(), nperf);
@@ -898,6 +1016,27 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::
+    computeStartOfStepQuantities(const SolutionState& state0,
+                                 const WellState& xw)
+    {
+        asImpl().computeAccum(state0, 0);
+        asImpl().computeWellConnectionPressures(state0, xw);
+        start_quantities_computed_ = true;
+
+        // Keep the well connection pressures, they are overwritten
+        // during the iterations.
+        cached_perforation_densities_ = well_perforation_densities_;
+        cached_perforation_pressure_diffs_ = well_perforation_pressure_diffs_;
+        start_quantities_cached_ = true;
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     void
     BlackoilModelBase<Grid, Implementation>::
@@ -909,12 +1048,18 @@ namespace detail {
 
         // If we have VFP tables, we need the well connection
         // pressures for the "simple" hydrostatic correction
-        // between well depth and vfp table depth.
-        if (isVFPActive()) {
-            SolutionState state = asImpl().variableState(reservoir_state, well_state);
-            SolutionState state0 = state;
+        // between well depth and vfp table depth. In the first
+        // assembly of a step the constant state built for them
+        // also gives the start-of-step quantities, unless these
+        // (and the connection pressures) were restored already.
+        if (isVFPActive() && !(initial_assembly && start_quantities_computed_)) {
+            SolutionState state0 = asImpl().variableState(reservoir_state, well_state);
             asImpl().makeConstantState(state0);
-            asImpl().computeWellConnectionPressures(state0, well_state);
+            if (initial_assembly) {
+                computeStartOfStepQuantities(state0, well_state);
+            } else {
+                asImpl().computeWellConnectionPressures(state0, well_state);
+            }
         }
 
         // Possibly switch well controls and updating well state to
@@ -924,14 +1069,13 @@ namespace detail {
         // Create the primary variables.
         SolutionState state = asImpl().variableState(reservoir_state, well_state);
 
-        if (initial_assembly) {
+        if (initial_assembly && !start_quantities_computed_) {
             // Create the (constant, derivativeless) initial state.
             SolutionState state0 = state;
             asImpl().makeConstantState(state0);
             // Compute initial accumulation contributions
             // and well connection pressures.
-            asImpl().computeAccum(state0, 0);
-            asImpl().computeWellConnectionPressures(state0, well_state);
+            computeStartOfStepQuantities(state0, well_state);
         }
 
         // OPM_AD_DISKVAL(state.pressure);
@@ -983,20 +1127,32 @@ namespace detail {
         // The corresponding accumulation terms from the start of
         // the timestep (b^0_p*s^0_p etc.) were already computed
         // on the initial call to assemble() and stored in rq_[phase].accum[0].
+        // The viscosities are computed together with b, unless an
+        // implementation of computeAccum() does not provide them.
+        for (auto& rq : rq_) {
+            rq.mu = ADB::null();
+        }
         asImpl().computeAccum(state, 1);
 
         // Set up the common parts of the mass balance equations
         // for each active phase.
-        const V transi = subset(geo_.transmissibility(), ops_.internal_faces);
-        const V trans_nnc = ops_.nnc_trans;
-        V trans_all(transi.size() + trans_nnc.size());
-        trans_all << transi, trans_nnc;
+        const V& trans_all = geometryCache().trans_all;
 
         const std::vector<ADB> kr = asImpl().computeRelPerm(state);
-#pragma omp parallel for schedule(static)
+        // Make room for the upwind selectors before the parallel loop.
+        if (upwind_.size() < rq_.size()) {
+            upwind_.resize(rq_.size());
+        }
+        // On large grids the phases are assembled one at a time, so that
+        // the sparse matrix kernels can split each operation into cell
+        // and face ranges over all threads instead of using one thread
+        // per phase.
+#pragma omp parallel for schedule(static) if(detail::numPartitions(cells_.size()) == 1)
         for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
             const std::vector<PhasePresence>& cond = phaseCondition();
-            const ADB mu = asImpl().fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
+            const ADB mu = rq_[phaseIdx].mu.size() > 0
+                ? rq_[phaseIdx].mu
+                : asImpl().fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
             const ADB rho = asImpl().fluidDensity(canph_[phaseIdx], rq_[phaseIdx].b, state.rs, state.rv);
             asImpl().computeMassFlux(phaseIdx, trans_all, kr[canph_[phaseIdx]], mu, rho, state.canonical_phase_pressures[canph_[phaseIdx]], state);
 
@@ -1014,13 +1170,10 @@ namespace detail {
             const int po = fluid_.phaseUsage().phase_pos[ Oil ];
             const int pg = fluid_.phaseUsage().phase_pos[ Gas ];
 
-            const UpwindSelector<double> upwindOil(grid_, ops_,
-                                                rq_[po].dh.value());
-            const ADB rs_face = upwindOil.select(state.rs);
-
-            const UpwindSelector<double> upwindGas(grid_, ops_,
-                                                rq_[pg].dh.value());
-            const ADB rv_face = upwindGas.select(state.rv);
+            // Same head differences as the phase fluxes, so the selectors
+            // of computeMassFlux() are reused.
+            const ADB rs_face = upwindSelector(po, rq_[po].dh.value()).select(state.rs);
+            const ADB rv_face = upwindSelector(pg, rq_[pg].dh.value()).select(state.rv);
 
             residual_.material_balance_eq[ pg ] += ops_.div * (rs_face * rq_[po].mflux);
             residual_.material_balance_eq[ po ] += ops_.div * (rv_face * rq_[pg].mflux);
@@ -1043,26 +1196,40 @@ namespace detail {
     template <class Grid, class Implementation>
     void
     BlackoilModelBase<Grid, Implementation>::updateEquationsScaling() {
-        ADB::V B;
         const Opm::PhaseUsage& pu = fluid_.phaseUsage();
-        for ( int idx=0; idx<MaxNumPhases; ++idx )
-        {
-            if (active_[idx]) {
-                const int pos    = pu.phase_pos[idx];
-                const ADB& temp_b = rq_[pos].b;
-                B = 1. / temp_b.value();
 #if HAVE_MPI
-                if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
-                {
-                    const ParallelISTLInformation& real_info =
-                        boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
-                    double B_global_sum = 0;
-                    real_info.computeReduction(B, Reduction::makeGlobalSumFunctor<double>(), B_global_sum);
-                    residual_.matbalscale[idx] = B_global_sum / global_nc_;
+        if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
+        {
+            const ParallelISTLInformation& real_info =
+                boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
+            // The sums of all phases over the owned cells are reduced together.
+            std::vector<double> B_global_sum(MaxNumPhases, 0.0);
+            for ( int idx=0; idx<MaxNumPhases; ++idx )
+            {
+                if (active_[idx]) {
+                    const V& b = rq_[pu.phase_pos[idx]].b.value();
+                    for (const int c : owned_cells_) {
+                        B_global_sum[idx] += 1. / b[c];
+                    }
+                }
+            }
+            real_info.communicator().sum(B_global_sum.data(), MaxNumPhases);
+            for ( int idx=0; idx<MaxNumPhases; ++idx )
+            {
+                if (active_[idx]) {
+                    residual_.matbalscale[idx] = B_global_sum[idx] / global_nc_;
                 }
-                else
+            }
+        }
+        else
 #endif
-                {
+        {
+            for ( int idx=0; idx<MaxNumPhases; ++idx )
+            {
+                if (active_[idx]) {
+                    const int pos    = pu.phase_pos[idx];
+                    const ADB& temp_b = rq_[pos].b;
+                    const ADB::V B = 1. / temp_b.value();
                     residual_.matbalscale[idx] = B.mean();
                 }
             }
@@ -1112,12 +1279,11 @@ namespace detail {
             return;
         } else {
             const int np = asImpl().numPhases();
-            const std::vector<int>& well_cells = wops_.well_cells;
             mob_perfcells.resize(np, ADB::null());
             b_perfcells.resize(np, ADB::null());
             for (int phase = 0; phase < np; ++phase) {
-                mob_perfcells[phase] = subset(rq_[phase].mob, well_cells);
-                b_perfcells[phase] = subset(rq_[phase].b, well_cells);
+                mob_perfcells[phase] = wops_.c2p * rq_[phase].mob;
+                b_perfcells[phase] = wops_.c2p * rq_[phase].b;
             }
         }
     }
@@ -1142,14 +1308,13 @@ namespace detail {
         const int nperf = wells().well_connpos[nw];
         const Opm::PhaseUsage& pu = fluid_.phaseUsage();
         V Tw = Eigen::Map<const V>(wells().WI, nperf);
-        const std::vector<int>& well_cells = wops_.well_cells;
 
         // pressure diffs computed already (once per step, not changing per iteration)
         const V& cdp = well_perforation_pressure_diffs_;
         // Extract needed quantities for the perforation cells
-        const ADB& p_perfcells = subset(state.pressure, well_cells);
-        const ADB& rv_perfcells = subset(state.rv, well_cells);
-        const ADB& rs_perfcells = subset(state.rs, well_cells);
+        const ADB& p_perfcells = wops_.c2p * state.pressure;
+        const ADB& rv_perfcells = wops_.c2p * state.rv;
+        const ADB& rs_perfcells = wops_.c2p * state.rs;
 
         // Perforation pressure
         const ADB perfpressure = (wops_.w2p * state.bhp) + cdp;
@@ -1537,7 +1702,8 @@ namespace detail {
                     break;
                 }
             }
-            if (ctrl_index != nwc) {
+            const bool switched = (ctrl_index != nwc);
+            if (switched) {
                 // Constraint number ctrl_index was broken, switch to it.
                 if (terminal_output_)
                 {
@@ -1580,6 +1746,20 @@ namespace detail {
                 const double& thp    = well_controls_iget_target(wc, current);
                 const double& alq    = well_controls_iget_alq(wc, current);
 
+                // When switching to THP control, start from the rates
+                // that the tubing carries at the current bhp, so that
+                // the bhp computed from them stays close to it.
+                auto scaleRates = [&](const double scale) {
+                    if (scale > 0.0) {
+                        for (int phase = 0; phase < np; ++phase) {
+                            xw.wellRates()[w*np + phase] *= scale;
+                        }
+                        aqua *= scale;
+                        liquid *= scale;
+                        vapour *= scale;
+                    }
+                };
+
                 //Set *BHP* target by calculating bhp from THP
                 const WellType& well_type = wells().type[w];
 
@@ -1588,6 +1768,9 @@ namespace detail {
                             wells(), w, vfp_properties_.getInj()->getTable(vfp)->getDatumDepth(),
                             well_perforation_densities_, gravity);
 
+                    if (switched) {
+                        scaleRates(vfp_properties_.getInj()->rateScaling(vfp, aqua, liquid, vapour, xw.bhp()[w] + dp, thp));
+                    }
                     xw.bhp()[w] = vfp_properties_.getInj()->bhp(vfp, aqua, liquid, vapour, thp) - dp;
                 }
                 else if (well_type == PRODUCER) {
@@ -1595,6 +1778,9 @@ namespace detail {
                             wells(), w, vfp_properties_.getProd()->getTable(vfp)->getDatumDepth(),
                             well_perforation_densities_, gravity);
 
+                    if (switched) {
+                        scaleRates(vfp_properties_.getProd()->rateScaling(vfp, aqua, liquid, vapour, xw.bhp()[w] + dp, thp, alq));
+                    }
                     xw.bhp()[w] = vfp_properties_.getProd()->bhp(vfp, aqua, liquid, vapour, thp, alq) - dp;
                 }
                 else {
@@ -1632,6 +1818,10 @@ namespace detail {
                                                               SolutionState& state,
                                                               WellState& well_state)
     {
+        if (param_.local_well_solver_ && asImpl().canSolveWellEqLocal()) {
+            return solveWellEqLocal(mob_perfcells, b_perfcells, state, well_state);
+        }
+
         V aliveWells;
         const int np = wells().number_of_phases;
         std::vector<ADB> cq_s(np, ADB::null());
@@ -1681,15 +1871,9 @@ namespace detail {
                 eqs.push_back(residual_.well_flux_eq);
                 eqs.push_back(residual_.well_eq);
                 ADB total_residual = vertcatCollapseJacs(eqs);
-                const std::vector<M>& Jn = total_residual.derivative();
-                typedef Eigen::SparseMatrix<double> Sp;
-                Sp Jn0;
-                Jn[0].toSparse(Jn0);
-                const Eigen::SparseLU< Sp > solver(Jn0);
-                ADB::V total_residual_v = total_residual.value();
-                const Eigen::VectorXd& dx = solver.solve(total_residual_v.matrix());
-                assert(dx.size() == total_residual_v.size());
-                asImpl().updateWellState(dx.array(), well_state);
+                const V dx = asImpl().solveWellLinearSystem(total_residual);
+                assert(dx.size() == total_residual.size());
+                asImpl().updateWellState(dx, well_state);
                 asImpl().updateWellControls(well_state);
             }
         } while (it < 15);
@@ -1731,6 +1915,260 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    V
+    BlackoilModelBase<Grid, Implementation>::solveWellLinearSystem(const ADB& total_residual) const
+    {
+        const std::vector<M>& Jn = total_residual.derivative();
+        typedef Eigen::SparseMatrix<double> Sp;
+        Sp Jn0;
+        Jn[0].toSparse(Jn0);
+        const Eigen::SparseLU< Sp > solver(Jn0);
+        ADB::V total_residual_v = total_residual.value();
+        const Eigen::VectorXd& dx = solver.solve(total_residual_v.matrix());
+        return dx.array();
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    bool BlackoilModelBase<Grid, Implementation>::canSolveWellEqLocal() const
+    {
+        // Wells under THP control need the VFP tables in the control
+        // equation, which only the solver for all wells handles.
+        int can_solve = !isVFPActive();
+#if HAVE_MPI
+        if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
+        {
+            // All processes must take the same path, since both do
+            // global reductions.
+            const ParallelISTLInformation& info =
+                boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
+            can_solve = info.communicator().min(can_solve);
+        }
+#endif
+        return can_solve;
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    LocalWellEquations
+    BlackoilModelBase<Grid, Implementation>::localWellEquations(const int w,
+                                                                const std::vector<ADB>& mob_perfcells,
+                                                                const std::vector<ADB>& b_perfcells,
+                                                                const SolutionState& state,
+                                                                const WellState& well_state) const
+    {
+        const int np = wells().number_of_phases;
+        const Opm::PhaseUsage& pu = fluid_.phaseUsage();
+        const std::vector<int>& well_cells = wops_.well_cells;
+
+        const std::vector<double> comp_frac(wells().comp_frac + w*np, wells().comp_frac + (w + 1)*np);
+        LocalWellEquations eq(np,
+                              active_[Oil] ? pu.phase_pos[Oil] : -1,
+                              active_[Gas] ? pu.phase_pos[Gas] : -1,
+                              wells().type[w] == INJECTOR,
+                              wells().allow_cf[w],
+                              comp_frac);
+
+        std::vector<double> mob(np);
+        std::vector<double> b(np);
+        for (int perf = wells().well_connpos[w]; perf < wells().well_connpos[w+1]; ++perf) {
+            const int cell = well_cells[perf];
+            for (int phase = 0; phase < np; ++phase) {
+                mob[phase] = mob_perfcells[phase].value()[perf];
+                b[phase] = b_perfcells[phase].value()[perf];
+            }
+            eq.addPerforation(wells().WI[perf],
+                              state.pressure.value()[cell],
+                              well_perforation_pressure_diffs_[perf],
+                              state.rs.value()[cell],
+                              state.rv.value()[cell],
+                              mob.data(), b.data());
+        }
+
+        const WellControls* wc = wells().ctrls[w];
+        const int current = well_state.currentControls()[w];
+        switch (well_controls_iget_type(wc, current)) {
+        case BHP:
+            eq.setControl(LocalWellEquations::Bhp, well_controls_iget_target(wc, current), 0);
+            break;
+        case RESERVOIR_RATE: // Intentional fall-through
+        case SURFACE_RATE:
+            eq.setControl(LocalWellEquations::Rate, well_controls_iget_target(wc, current),
+                          well_controls_iget_distr(wc, current));
+            break;
+        case THP:
+            OPM_THROW(std::logic_error, "THP controlled wells are not supported by the local well solver.");
+        }
+        return eq;
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    bool BlackoilModelBase<Grid, Implementation>::solveWellEqLocal(const std::vector<ADB>& mob_perfcells,
+                                                                   const std::vector<ADB>& b_perfcells,
+                                                                   SolutionState& state,
+                                                                   WellState& well_state)
+    {
+        const int np = asImpl().numPhases();
+        const int nw = localWellsActive() ? wells().number_of_wells : 0;
+        const double tol_wells = param_.tolerance_wells_;
+        const double dpmaxrel = dpMaxRel();
+        const WellState well_state0 = well_state;
+
+        // The flux residuals are scaled by the average reciprocal formation
+        // volume factors, as in getWellConvergence(). They do not change
+        // while the reservoir state is fixed.
+        std::vector<double> B_avg(np, 0.0);
+        for (int phase = 0; phase < np; ++phase) {
+            const V& b = rq_[phase].b.value();
+            if (owned_cells_.empty()) {
+                B_avg[phase] = (1.0 / b).sum();
+            } else {
+                for (const int c : owned_cells_) {
+                    B_avg[phase] += 1.0 / b[c];
+                }
+            }
+        }
+#if HAVE_MPI
+        if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
+        {
+            const ParallelISTLInformation& info =
+                boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
+            info.communicator().sum(B_avg.data(), np);
+        }
+#endif
+        for (int phase = 0; phase < np; ++phase) {
+            B_avg[phase] /= global_nc_;
+        }
+
+        // Wells are iterated independently, and converged wells are left
+        // alone unless a control switch changes their equations.
+        std::vector<int> well_converged(nw, 0);
+        int it = 0;
+        bool converged = false;
+        do {
+            int num_unconverged = 0;
+            int num_failed = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+:num_unconverged,num_failed)
+            for (int w = 0; w < nw; ++w) {
+                if (well_converged[w]) {
+                    continue;
+                }
+                const LocalWellEquations eq = localWellEquations(w, mob_perfcells, b_perfcells, state, well_state);
+                LocalWellEquations::Vector x(np + 1);
+                for (int phase = 0; phase < np; ++phase) {
+                    x[phase] = well_state.wellRates()[w*np + phase];
+                }
+                x[np] = well_state.bhp()[w];
+
+                LocalWellEquations::Vector res;
+                LocalWellEquations::Matrix jac;
+                std::vector<double> perf_rates;
+                eq.linearise(x, res, jac, perf_rates);
+
+                bool conv = std::abs(res[np]) < Opm::unit::barsa;
+                for (int phase = 0; phase < np; ++phase) {
+                    const double flux_residual = B_avg[phase] * std::abs(res[phase]);
+                    if (std::isnan(flux_residual) || flux_residual > maxResidualAllowed()) {
+                        ++num_failed;
+                    }
+                    conv = conv && flux_residual < tol_wells;
+                }
+
+                // Connection rates and pressures of the current iterate.
+                const int first_perf = wells().well_connpos[w];
+                std::copy(perf_rates.begin(), perf_rates.end(), well_state.perfPhaseRates().begin() + first_perf*np);
+                for (int perf = first_perf; perf < wells().well_connpos[w+1]; ++perf) {
+                    well_state.perfPress()[perf] = x[np] + well_perforation_pressure_diffs_[perf];
+                }
+
+                if (conv) {
+                    well_converged[w] = 1;
+                    continue;
+                }
+                ++num_unconverged;
+
+                const LocalWellEquations::Vector dx = jac.partialPivLu().solve(res);
+                for (int phase = 0; phase < np; ++phase) {
+                    well_state.wellRates()[w*np + phase] -= dx[phase];
+                }
+                const double dbhp_limit = std::abs(x[np]) * dpmaxrel;
+                const double dbhp = std::max(-dbhp_limit, std::min(dx[np], dbhp_limit));
+                well_state.bhp()[w] -= dbhp;
+            }
+            // Exceptions can not leave the parallel loop, so they are thrown here.
+            if (num_failed > 0) {
+                OPM_THROW(Opm::NumericalProblem, "NaN or too large residual in the local well equations.");
+            }
+
+#if HAVE_MPI
+            if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
+            {
+                const ParallelISTLInformation& info =
+                    boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
+                num_unconverged = info.communicator().sum(num_unconverged);
+            }
+#endif
+            converged = num_unconverged == 0;
+            if (converged) {
+                break;
+            }
+
+            ++it;
+            if (localWellsActive()) {
+                const std::vector<int> controls = well_state.currentControls();
+                asImpl().updateWellControls(well_state);
+                for (int w = 0; w < nw; ++w) {
+                    if (well_state.currentControls()[w] != controls[w]) {
+                        well_converged[w] = 0;
+                    }
+                }
+            }
+        } while (it < 15);
+
+        if (converged) {
+            if ( terminal_output_ ) {
+                std::cout << "well converged iter: " << it << std::endl;
+            }
+            {
+                // We will set the bhp primary variable to the new ones,
+                // but we do not change the derivatives here.
+                ADB::V new_bhp = Eigen::Map<ADB::V>(well_state.bhp().data(), nw);
+                std::vector<ADB::M> old_derivs = state.bhp.derivative();
+                state.bhp = ADB::function(std::move(new_bhp), std::move(old_derivs));
+            }
+            {
+                // Need to reshuffle well rates, from phase running fastest
+                // to wells running fastest.
+                const DataBlock wrates = Eigen::Map<const DataBlock>(well_state.wellRates().data(), nw, np).transpose();
+                ADB::V new_qs = Eigen::Map<const V>(wrates.data(), nw*np);
+                std::vector<ADB::M> old_derivs = state.qs.derivative();
+                state.qs = ADB::function(std::move(new_qs), std::move(old_derivs));
+            }
+            asImpl().computeWellConnectionPressures(state, well_state);
+        }
+
+        if (!converged) {
+            well_state = well_state0;
+        }
+
+        return converged;
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     void BlackoilModelBase<Grid, Implementation>::addWellControlEq(const SolutionState& state,
                                                           const WellState& xw,
@@ -2002,6 +2440,46 @@ namespace detail {
             return result;
         }
 
+#if HAVE_MPI
+        /// \brief MPI reduction operator for buffers holding a count n of
+        /// sums in their first entry, followed by n values to be summed
+        /// and by values to be maximised.
+        ///
+        /// Each buffer must be passed as one element of a contiguous
+        /// type of doubles, so that MPI never splits it.
+        inline
+        void sumThenMax(void* invec, void* inoutvec, int* len, MPI_Datatype* datatype)
+        {
+            int type_size = 0;
+            MPI_Type_size(*datatype, &type_size);
+            const int size = type_size / sizeof(double);
+            for (int e = 0; e < *len; ++e) {
+                const double* in = static_cast<const double*>(invec) + e*size;
+                double* inout = static_cast<double*>(inoutvec) + e*size;
+                const int num_sums = static_cast<int>(in[0]);
+                for (int i = 1; i <= num_sums; ++i) {
+                    inout[i] += in[i];
+                }
+                for (int i = num_sums + 1; i < size; ++i) {
+                    inout[i] = std::max(inout[i], in[i]);
+                }
+            }
+        }
+
+        /// \brief The sumThenMax() reduction, created on first use and
+        /// kept until MPI is finalized.
+        inline
+        MPI_Op sumThenMaxOp()
+        {
+            static const MPI_Op op = []() {
+                MPI_Op created;
+                MPI_Op_create(&sumThenMax, 1, &created);
+                return created;
+            }();
+            return op;
+        }
+#endif
+
     } // namespace detail
 
 
@@ -2424,12 +2902,18 @@ namespace detail {
                                                              const SolutionState&    state)
     {
         // Compute and store mobilities.
-        const ADB tr_mult = transMult(state.pressure);
-        rq_[ actph ].mob = tr_mult * kr / mu;
+        if (hasRockCompressibility()) {
+            const ADB tr_mult = transMult(state.pressure);
+            rq_[ actph ].mob = tr_mult * kr / mu;
+        } else {
+            rq_[ actph ].mob = kr / mu;
+        }
 
         // Compute head differentials. Gravity potential is done using the face average as in eclipse and MRST.
+        // The depth differences are refreshed by assembleMassBalanceEq(),
+        // outside of the parallel phase loop.
         const ADB rhoavg = ops_.caver * rho;
-        rq_[ actph ].dh = ops_.ngrad * phasePressure - geo_.gravity()[2] * (rhoavg * (ops_.ngrad * geo_.z().matrix()));
+        rq_[ actph ].dh = ops_.ngrad * phasePressure - rhoavg * geom_cache_.gdz;
         if (use_threshold_pressure_) {
             applyThresholdPressures(rq_[ actph ].dh);
         }
@@ -2438,7 +2922,7 @@ namespace detail {
         const ADB& b   = rq_[ actph ].b;
         const ADB& mob = rq_[ actph ].mob;
         const ADB& dh  = rq_[ actph ].dh;
-        UpwindSelector<double> upwind(grid_, ops_, dh.value());
+        const UpwindSelector<double>& upwind = upwindSelector(actph, dh.value());
         rq_[ actph ].mflux = upwind.select(b * mob) * (transi * dh);
     }
 
@@ -2446,6 +2930,24 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    const UpwindSelector<double>&
+    BlackoilModelBase<Grid, Implementation>::upwindSelector(const int pos, const V& dh)
+    {
+        assert(pos < int(upwind_.size()));
+        std::unique_ptr<UpwindSelector<double> >& upwind = upwind_[pos];
+        if (upwind) {
+            upwind->update(dh);
+        } else {
+            upwind.reset(new UpwindSelector<double>(grid_, ops_, dh));
+        }
+        return *upwind;
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     void
     BlackoilModelBase<Grid, Implementation>::applyThresholdPressures(ADB& dp)
@@ -2575,6 +3077,11 @@ namespace detail {
         const int nw = residual_.well_flux_eq.size() / np;
         assert(nw * np == int(residual_.well_flux_eq.size()));
 
+        B_avg.resize(nm);
+        maxCoeff.resize(nm);
+        R_sum.resize(nm);
+        maxNormWell.resize(np);
+
         // Do the global reductions
 #if HAVE_MPI
         if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
@@ -2582,46 +3089,51 @@ namespace detail {
             const ParallelISTLInformation& info =
                 boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
 
-            // Compute the global number of cells and porevolume
-            std::vector<int> v(nc, 1);
-            auto nc_and_pv = std::tuple<int, double>(0, 0.0);
-            auto nc_and_pv_operators = std::make_tuple(Opm::Reduction::makeGlobalSumFunctor<int>(),
-                                                        Opm::Reduction::makeGlobalSumFunctor<double>());
-            auto nc_and_pv_containers  = std::make_tuple(v, geo_.poreVolume());
-            info.computeReduction(nc_and_pv_containers, nc_and_pv_operators, nc_and_pv);
-
+            // All sums and maxima are packed into one buffer and reduced
+            // by a single collective, since with many processes the cost
+            // of these reductions is dominated by latency. The layout is
+            // [count of sums, B sums, R sums, tempV maxima, well maxima].
+            // Overlap cells are skipped, their values are owned elsewhere.
+            const int num_sums = 2 * nm;
+            std::vector<double> buffer(1 + num_sums + nm + np, 0.0);
+            buffer[0] = num_sums;
+            double* const B_part = buffer.data() + 1;
+            double* const R_part = B_part + nm;
+            double* const tempV_part = R_part + nm;
+            double* const well_part = tempV_part + nm;
             for ( int idx = 0; idx < nm; ++idx )
             {
-                auto values     = std::tuple<double,double,double>(0.0 ,0.0 ,0.0);
-                auto containers = std::make_tuple(B.col(idx),
-                                                  tempV.col(idx),
-                                                  R.col(idx));
-                auto operators  = std::make_tuple(Opm::Reduction::makeGlobalSumFunctor<double>(),
-                                                  Opm::Reduction::makeGlobalMaxFunctor<double>(),
-                                                  Opm::Reduction::makeGlobalSumFunctor<double>());
-                info.computeReduction(containers, operators, values);
-                B_avg[idx]       = std::get<0>(values)/std::get<0>(nc_and_pv);
-                maxCoeff[idx]    = std::get<1>(values);
-                R_sum[idx]       = std::get<2>(values);
+                for (const int c : owned_cells_) {
+                    B_part[idx] += B(c, idx);
+                    R_part[idx] += R(c, idx);
+                    tempV_part[idx] = std::max(tempV_part[idx], tempV(c, idx));
+                }
                 assert(nm >= np);
                 if (idx < np) {
-                    maxNormWell[idx] = 0.0;
                     for ( int w = 0; w < nw; ++w ) {
-                        maxNormWell[idx]  = std::max(maxNormWell[idx], std::abs(residual_.well_flux_eq.value()[nw*idx + w]));
+                        well_part[idx] = std::max(well_part[idx], std::abs(residual_.well_flux_eq.value()[nw*idx + w]));
                     }
                 }
             }
-            info.communicator().max(maxNormWell.data(), np);
-            // Compute pore volume
-            return std::get<1>(nc_and_pv);
-        }
+
+            MPI_Datatype buffer_type;
+            MPI_Type_contiguous(buffer.size(), MPI_DOUBLE, &buffer_type);
+            MPI_Type_commit(&buffer_type);
+            MPI_Allreduce(MPI_IN_PLACE, buffer.data(), 1, buffer_type, detail::sumThenMaxOp(),
+                          info.communicator());
+            MPI_Type_free(&buffer_type);
+
+            for ( int idx = 0; idx < nm; ++idx )
+            {
+                B_avg[idx]    = B_part[idx] / global_nc_;
+                R_sum[idx]    = R_part[idx];
+                maxCoeff[idx] = tempV_part[idx];
+            }
+            std::copy(well_part, well_part + np, maxNormWell.begin());
+        }
         else
 #endif
         {
-            B_avg.resize(nm);
-            maxCoeff.resize(nm);
-            R_sum.resize(nm);
-            maxNormWell.resize(np);
             for ( int idx = 0; idx < nm; ++idx )
             {
                 B_avg[idx] = B.col(idx).sum()/nc;
@@ -2636,9 +3148,9 @@ namespace detail {
                     }
                 }
             }
-            // Compute total pore volume
-            return geo_.poreVolume().sum();
         }
+        // The total pore volume is computed once per geology.
+        return geom_cache_.pore_volume;
     }
 
 
@@ -2707,6 +3219,7 @@ namespace detail {
                                                                  linsolver_.parallelInformation());
         converged_Well = converged_Well && (residualWell < Opm::unit::barsa);
         const bool converged = converged_MB && converged_CNV && converged_Well;
+        reservoir_converged_ = converged_MB && converged_CNV;
 
         // Residual in Pascal can have high values and still be ok.
         const double maxWellResidualAllowed = 1000.0 * maxResidualAllowed();
@@ -2848,6 +3361,369 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    int
+    BlackoilModelBase<Grid, Implementation>::
+    localNonlinearIterations(const double dt,
+                             ReservoirState& reservoir_state,
+                             WellState& well_state)
+    {
+#if HAVE_MPI
+        // The subdomains may cross process boundaries, so the local
+        // solves are only done in serial runs.
+        if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) ) {
+            return 0;
+        }
+#endif
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+        const int nm = asImpl().numMaterials();
+        const double tol_cnv = param_.tolerance_cnv_;
+        const V& pv = geo_.poreVolume();
+
+        // The first nm primary variables are the cell variables, with
+        // one equation each. The remaining ones are well variables,
+        // which are kept fixed.
+        const std::vector<int> block_offset = primaryVariableOffsets();
+        const int num_blocks = block_offset.size() - 1;
+        if (num_blocks < nm) {
+            return 0;
+        }
+        for (int block = 0; block < nm; ++block) {
+            if (block_offset[block + 1] - block_offset[block] != nc) {
+                return 0;
+            }
+        }
+
+        typedef Eigen::SparseMatrix<double> Sp;
+        typedef Eigen::Triplet<double> Tri;
+
+        int it = 0;
+        int num_subdomain_cells = 0;
+        for (; it < param_.local_solve_max_iter_; ++it) {
+            // Find the cells violating the CNV criterion, using the same
+            // scaling as getConvergence().
+            std::vector<char> in_subdomain(nc, 0);
+            for (int idx = 0; idx < nm; ++idx) {
+                const V B = 1.0 / rq_[idx].b.value();
+                const double scale = B.sum() / nc * dt;
+                const V& R = residual_.material_balance_eq[idx].value();
+                for (int c = 0; c < nc; ++c) {
+                    if (scale * std::abs(R[c]) / pv[c] >= tol_cnv) {
+                        in_subdomain[c] = 1;
+                    }
+                }
+            }
+
+            // Add layers of neighbours across all connections.
+            for (int layer = 0; layer < param_.local_solve_overlap_; ++layer) {
+                std::vector<char> grown = in_subdomain;
+                for (int conn = 0; conn < ops_.div.outerSize(); ++conn) {
+                    bool touches = false;
+                    for (HelperOps::M::InnerIterator i(ops_.div, conn); i; ++i) {
+                        touches = touches || in_subdomain[i.row()];
+                    }
+                    if (touches) {
+                        for (HelperOps::M::InnerIterator i(ops_.div, conn); i; ++i) {
+                            grown[i.row()] = 1;
+                        }
+                    }
+                }
+                in_subdomain.swap(grown);
+            }
+
+            std::vector<int> subdomain;
+            std::vector<int> local_index(nc, -1);
+            for (int c = 0; c < nc; ++c) {
+                if (in_subdomain[c]) {
+                    local_index[c] = subdomain.size();
+                    subdomain.push_back(c);
+                }
+            }
+            const int ns = subdomain.size();
+            if (ns == 0 || ns > param_.local_solve_max_cell_fraction_ * nc) {
+                break;
+            }
+            num_subdomain_cells = ns;
+
+            // Restrict the linearised mass balance equations to the subdomain.
+            std::vector<Tri> triplets;
+            Eigen::VectorXd r(nm * ns);
+            for (int eq = 0; eq < nm; ++eq) {
+                const ADB& mb = residual_.material_balance_eq[eq];
+                for (int i = 0; i < ns; ++i) {
+                    r[eq*ns + i] = mb.value()[subdomain[i]];
+                }
+                for (int var = 0; var < nm; ++var) {
+                    Sp jac;
+                    mb.derivative()[var].toSparse(jac);
+                    for (int col = 0; col < jac.outerSize(); ++col) {
+                        const int local_col = local_index[col];
+                        if (local_col < 0) {
+                            continue;
+                        }
+                        for (Sp::InnerIterator i(jac, col); i; ++i) {
+                            const int local_row = local_index[i.row()];
+                            if (local_row >= 0) {
+                                triplets.emplace_back(eq*ns + local_row, var*ns + local_col, i.value());
+                            }
+                        }
+                    }
+                }
+            }
+            Sp J(nm * ns, nm * ns);
+            J.setFromTriplets(triplets.begin(), triplets.end());
+            Eigen::SparseLU<Sp> solver(J);
+            if (solver.info() != Eigen::Success) {
+                break;
+            }
+            const Eigen::VectorXd dx_local = solver.solve(r);
+
+            V dx = V::Zero(block_offset[num_blocks]);
+            for (int var = 0; var < nm; ++var) {
+                for (int i = 0; i < ns; ++i) {
+                    dx[block_offset[var] + subdomain[i]] = dx_local[var*ns + i];
+                }
+            }
+            asImpl().updateState(dx, reservoir_state, well_state);
+            asImpl().assemble(reservoir_state, well_state, false);
+        }
+
+        if (terminal_output_ && it > 0) {
+            std::cout << "Local iterations: " << it
+                      << " (last subdomain " << num_subdomain_cells << " cells)" << std::endl;
+        }
+        return it;
+    }
+
+
+
+
+
+
+    template <class Grid, class Implementation>
+    std::vector<int>
+    BlackoilModelBase<Grid, Implementation>::primaryVariableOffsets() const
+    {
+        const ADB& eq0 = residual_.material_balance_eq[0];
+        const int num_blocks = eq0.numBlocks();
+        std::vector<int> offset(num_blocks + 1, 0);
+        for (int block = 0; block < num_blocks; ++block) {
+            offset[block + 1] = offset[block] + eq0.derivative()[block].cols();
+        }
+        return offset;
+    }
+
+
+
+
+
+    namespace detail
+    {
+        /// Extract the columns of a sparse matrix for which col_map is
+        /// nonnegative, placing column col in column col_map[col].
+        template <class Matrix>
+        Matrix selectColumns(const Eigen::SparseMatrix<double>& A,
+                             const std::vector<int>& col_map,
+                             const int num_selected)
+        {
+            typedef Eigen::SparseMatrix<double> Sp;
+            std::vector< Eigen::Triplet<double> > t;
+            t.reserve(A.nonZeros());
+            for (int col = 0; col < A.outerSize(); ++col) {
+                if (col_map[col] < 0) {
+                    continue;
+                }
+                for (Sp::InnerIterator i(A, col); i; ++i) {
+                    t.emplace_back(i.row(), col_map[col], i.value());
+                }
+            }
+            Matrix selected(A.rows(), num_selected);
+            selected.setFromTriplets(t.begin(), t.end());
+            return selected;
+        }
+    } // namespace detail
+
+
+
+
+
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::
+    sequentialUpdate(const double dt,
+                     ReservoirState& reservoir_state,
+                     WellState& well_state)
+    {
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+        const int nm = asImpl().numMaterials();
+        const std::vector<int> offset = primaryVariableOffsets();
+        if (int(offset.size()) <= nm || offset[nm] != nm * nc) {
+            OPM_THROW(std::logic_error, "Sequential implicit solution requires the cell variables to come first.");
+        }
+
+        // Pressure step.
+        asImpl().updateState(asImpl().solvePressureSystem(), reservoir_state, well_state);
+        if (nm < 2) {
+            return;
+        }
+
+        // Transport steps. The convergence check is the CNV criterion of
+        // getConvergence(), applied to the transport equations only.
+        const int pressure_eq = active_[Oil] ? fluid_.phaseUsage().phase_pos[Oil] : 0;
+        const V& pv = geo_.poreVolume();
+        int it = 0;
+        for (; it < param_.sequential_max_transport_iter_; ++it) {
+            asImpl().assembleTransportEq(reservoir_state, well_state);
+            double max_cnv = 0.0;
+            for (int idx = 0; idx < nm; ++idx) {
+                if (idx == pressure_eq) {
+                    continue;
+                }
+                const double B_avg = (1.0 / rq_[idx].b.value()).sum() / nc;
+                const V& R = residual_.material_balance_eq[idx].value();
+                max_cnv = std::max(max_cnv, B_avg * dt * (R.abs() / pv).maxCoeff());
+            }
+            if (max_cnv < param_.tolerance_cnv_) {
+                break;
+            }
+            asImpl().updateState(asImpl().solveTransportSystem(), reservoir_state, well_state);
+        }
+        if (terminal_output_) {
+            std::cout << "Transport iterations: " << it << std::endl;
+        }
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::
+    assembleTransportEq(const ReservoirState& reservoir_state,
+                        WellState& well_state)
+    {
+        SolutionState state = asImpl().variableState(reservoir_state, well_state);
+        state.pressure = ADB::constant(state.pressure.value());
+        state.qs = ADB::constant(state.qs.value());
+        state.bhp = ADB::constant(state.bhp.value());
+
+        asImpl().assembleMassBalanceEq(state);
+
+        if ( ! wellsActive() ) {
+            return;
+        }
+
+        // Only the well source terms of the mass balance equations.
+        std::vector<ADB> mob_perfcells;
+        std::vector<ADB> b_perfcells;
+        asImpl().extractWellPerfProperties(mob_perfcells, b_perfcells);
+        V aliveWells;
+        std::vector<ADB> cq_s;
+        asImpl().computeWellFlux(state, mob_perfcells, b_perfcells, aliveWells, cq_s);
+        asImpl().addWellContributionToMassBalanceEq(cq_s, state, well_state);
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    V
+    BlackoilModelBase<Grid, Implementation>::solvePressureSystem() const
+    {
+        const int nm = asImpl().numMaterials();
+        const std::vector<int> offset = primaryVariableOffsets();
+        const int num_blocks = offset.size() - 1;
+
+        // Weighting by the inverse formation volume factors approximately
+        // removes the dependency on the transported quantities.
+        ADB pressure_eq = V(1.0 / rq_[0].b.value()) * residual_.material_balance_eq[0];
+        for (int idx = 1; idx < nm; ++idx) {
+            pressure_eq += V(1.0 / rq_[idx].b.value()) * residual_.material_balance_eq[idx];
+        }
+        const ADB well_res = vertcat(residual_.well_flux_eq, residual_.well_eq);
+        const ADB total_residual = collapseJacs(vertcat(pressure_eq, well_res));
+
+        // Keep the pressure and well variables.
+        std::vector<int> col_map(offset[num_blocks], -1);
+        int num_selected = 0;
+        for (int block = 0; block < num_blocks; ++block) {
+            if (block == 0 || block >= nm) {
+                for (int col = offset[block]; col < offset[block + 1]; ++col) {
+                    col_map[col] = num_selected++;
+                }
+            }
+        }
+        typedef Eigen::SparseMatrix<double> Sp;
+        Sp J;
+        total_residual.derivative()[0].toSparse(J);
+        const Sp A = detail::selectColumns<Sp>(J, col_map, num_selected);
+        const Eigen::SparseLU<Sp> solver(A);
+        if (solver.info() != Eigen::Success) {
+            OPM_THROW(LinearSolverProblem, "Factorisation of the pressure system failed.");
+        }
+        ADB::V rhs = total_residual.value();
+        const Eigen::VectorXd x = solver.solve(rhs.matrix());
+
+        V dx = V::Zero(offset[num_blocks]);
+        for (int col = 0; col < offset[num_blocks]; ++col) {
+            if (col_map[col] >= 0) {
+                dx[col] = x[col_map[col]];
+            }
+        }
+        return dx;
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    V
+    BlackoilModelBase<Grid, Implementation>::solveTransportSystem() const
+    {
+        const int nc = Opm::AutoDiffGrid::numCells(grid_);
+        const int nm = asImpl().numMaterials();
+        const std::vector<int> offset = primaryVariableOffsets();
+        const int num_blocks = offset.size() - 1;
+        const int pressure_eq = active_[Oil] ? fluid_.phaseUsage().phase_pos[Oil] : 0;
+
+        // The transport equations are all mass balance equations except
+        // the one used for pressure, and the unknowns are the cell
+        // variables after pressure.
+        ADB transport_eqs = ADB::null();
+        bool first = true;
+        for (int idx = 0; idx < nm; ++idx) {
+            if (idx == pressure_eq) {
+                continue;
+            }
+            transport_eqs = first ? residual_.material_balance_eq[idx]
+                                  : vertcat(transport_eqs, residual_.material_balance_eq[idx]);
+            first = false;
+        }
+        transport_eqs = collapseJacs(transport_eqs);
+
+        std::vector<int> col_map(offset[num_blocks], -1);
+        for (int col = offset[1]; col < offset[nm]; ++col) {
+            col_map[col] = col - offset[1];
+        }
+        typedef Eigen::SparseMatrix<double> Sp;
+        Sp J;
+        transport_eqs.derivative()[0].toSparse(J);
+        const Eigen::SparseMatrix<double, Eigen::RowMajor> A
+            = detail::selectColumns<Sp>(J, col_map, (nm - 1) * nc);
+        const V x = solveReorderedSystem(A, transport_eqs.value(), nc);
+
+        V dx = V::Zero(offset[num_blocks]);
+        dx.segment(offset[1], (nm - 1) * nc) = x;
+        return dx;
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     ADB
     BlackoilModelBase<Grid, Implementation>::fluidViscosity(const int               phase,
@@ -2898,6 +3774,24 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::fluidReciprocFVFAndViscosity(const int               phase,
+                                                                          const ADB&              p    ,
+                                                                          const ADB&              temp ,
+                                                                          const ADB&              rs   ,
+                                                                          const ADB&              rv   ,
+                                                                          const std::vector<PhasePresence>& cond,
+                                                                          ADB&                    b    ,
+                                                                          ADB&                    mu   ) const
+    {
+        fluid_.bAndMu(phase, p, temp, rs, rv, cond, cells_, b, mu);
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     ADB
     BlackoilModelBase<Grid, Implementation>::fluidDensity(const int  phase,
@@ -2973,6 +3867,66 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    const typename BlackoilModelBase<Grid, Implementation>::GeometryCache&
+    BlackoilModelBase<Grid, Implementation>::geometryCache()
+    {
+        if (geom_cache_.revision != geo_.revision()) {
+            const V transi = subset(geo_.transmissibility(), ops_.internal_faces);
+            const V& trans_nnc = ops_.nnc_trans;
+            geom_cache_.trans_all.resize(transi.size() + trans_nnc.size());
+            geom_cache_.trans_all << transi, trans_nnc;
+            const Eigen::VectorXd dz = ops_.ngrad * geo_.z().matrix();
+            geom_cache_.gdz = geo_.gravity()[2] * dz.array();
+#if HAVE_MPI
+            if ( linsolver_.parallelInformation().type() == typeid(ParallelISTLInformation) )
+            {
+                const ParallelISTLInformation& info =
+                    boost::any_cast<const ParallelISTLInformation&>(linsolver_.parallelInformation());
+                geom_cache_.pore_volume = 0.0;
+                info.computeReduction(geo_.poreVolume(), Opm::Reduction::makeGlobalSumFunctor<double>(),
+                                      geom_cache_.pore_volume);
+            }
+            else
+#endif
+            {
+                geom_cache_.pore_volume = geo_.poreVolume().sum();
+            }
+            geom_cache_.pvdt_dt = 0.0;
+            geom_cache_.revision = geo_.revision();
+        }
+        return geom_cache_;
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::updatePoreVolumeOverDt(const double dt)
+    {
+        if (geometryCache().pvdt_dt != dt) {
+            pvdt_ = geo_.poreVolume() / dt;
+            geom_cache_.pvdt_dt = dt;
+        }
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    bool
+    BlackoilModelBase<Grid, Implementation>::hasRockCompressibility() const
+    {
+        return rock_comp_props_ && rock_comp_props_->isActive();
+    }
+
+
+
+
+
     template <class Grid, class Implementation>
     ADB
     BlackoilModelBase<Grid, Implementation>::poroMult(const ADB& p) const
@@ -3122,6 +4076,105 @@ namespace detail {
 
 
 
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::extrapolateInitialGuess(const double dt,
+                                                                     ReservoirState& reservoir_state,
+                                                                     WellState& well_state)
+    {
+        using namespace Opm::AutoDiffGrid;
+        const int nc = numCells(grid_);
+        const int np = numPhases();
+        const int nw = localWellsActive() ? wells().number_of_wells : 0;
+
+        // Store the start-of-step variables, they become the history
+        // of the next step if this one is accepted.
+        StepStartHistory::Variables& x1 = step_history_->step_start;
+        x1.pressure   = Eigen::Map<const V>(reservoir_state.pressure().data(), nc);
+        x1.saturation = Eigen::Map<const DataBlock>(reservoir_state.saturation().data(), nc, np);
+        x1.rs         = Eigen::Map<const V>(reservoir_state.gasoilratio().data(), nc);
+        x1.rv         = Eigen::Map<const V>(reservoir_state.rv().data(), nc);
+        x1.bhp        = Eigen::Map<const V>(well_state.bhp().data(), nw);
+        x1.well_rates = Eigen::Map<const V>(well_state.wellRates().data(), nw*np);
+        x1.well_names.clear();
+        for (int w = 0; w < nw; ++w) {
+            x1.well_names.push_back(wells().name[w]);
+        }
+        x1.dt         = dt;
+
+        // The wells may change between report steps, the history is
+        // only used if they are the same.
+        const StepStartHistory::Variables& x0 = step_history_->last_accepted;
+        if (!step_history_->has_last_accepted || x0.dt <= 0.0
+            || x0.pressure.size() != nc || x0.well_names != x1.well_names) {
+            return;
+        }
+
+        // The accumulation terms and well connection pressures must be
+        // those of the true start of the step, not of the initial guess.
+        if (!start_quantities_computed_) {
+            asImpl().updateWellControls(well_state);
+            SolutionState state0 = asImpl().variableState(reservoir_state, well_state);
+            asImpl().makeConstantState(state0);
+            computeStartOfStepQuantities(state0, well_state);
+        }
+
+        // Build the update dx such that x1 - dx = x1 + ratio*(x1 - x0),
+        // in the same layout as the Newton update.
+        const double ratio = dt / x0.dt;
+        const Opm::PhaseUsage& pu = fluid_.phaseUsage();
+        V dx = V::Zero(nc * np + asImpl().numWellVars());
+        int varstart = 0;
+        dx.segment(varstart, nc) = ratio * (x0.pressure - x1.pressure);
+        varstart += nc;
+        if (active_[Water]) {
+            const int pos = pu.phase_pos[ Water ];
+            dx.segment(varstart, nc) = ratio * (x0.saturation.col(pos) - x1.saturation.col(pos));
+            varstart += nc;
+        }
+        if (active_[Gas]) {
+            const int pos = pu.phase_pos[ Gas ];
+            const V dsg = x0.saturation.col(pos) - x1.saturation.col(pos);
+            const V drs = x0.rs - x1.rs;
+            const V drv = x0.rv - x1.rv;
+            dx.segment(varstart, nc) = ratio * (isSg_*dsg + isRs_*drs + isRv_*drv);
+            varstart += nc;
+        }
+        if (nw > 0 && numWellVars() == asImpl().numWellVars()) {
+            // Well rates are ordered with phases running fastest in the
+            // well state, and with wells running fastest in dx.
+            for (int phase = 0; phase < np; ++phase) {
+                for (int w = 0; w < nw; ++w) {
+                    const double q1 = x1.well_rates[w*np + phase];
+                    const double dq = ratio * (x0.well_rates[w*np + phase] - q1);
+                    // Do not let the extrapolation reverse the flow direction.
+                    const bool reversed = (q1 - dq) * q1 < 0.0;
+                    dx[varstart + phase*nw + w] = reversed ? 0.0 : dq;
+                }
+            }
+            varstart += np*nw;
+            dx.segment(varstart, nw) = ratio * (x0.bhp - x1.bhp);
+        }
+
+        asImpl().updateState(dx, reservoir_state, well_state);
+    }
+
+
+
+
+
+    template <class Grid, class Implementation>
+    void
+    BlackoilModelBase<Grid, Implementation>::acceptStepStartVariables()
+    {
+        std::swap(step_history_->last_accepted, step_history_->step_start);
+        step_history_->has_last_accepted = true;
+    }
+
+
+
+
+
     /// Update the phaseCondition_ member based on the primalVariable_ member.
     template <class Grid, class Implementation>
     void
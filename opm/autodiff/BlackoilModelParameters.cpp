@@ -47,7 +47,15 @@ namespace Opm
         tolerance_cnv_   = param.getDefault("tolerance_cnv", tolerance_cnv_);
         tolerance_wells_ = param.getDefault("tolerance_wells", tolerance_wells_ );
         solve_welleq_initially_ = param.getDefault("solve_welleq_initially",solve_welleq_initially_);
+        local_well_solver_ = param.getDefault("local_well_solver", local_well_solver_);
+        well_only_iterations_ = param.getDefault("well_only_iterations", well_only_iterations_);
         update_equations_scaling_ = param.getDefault("update_equations_scaling", update_equations_scaling_);
+        extrapolate_initial_guess_ = param.getDefault("extrapolate_initial_guess", extrapolate_initial_guess_);
+        local_solve_max_iter_ = param.getDefault("local_solve_max_iter", local_solve_max_iter_);
+        local_solve_overlap_ = param.getDefault("local_solve_overlap", local_solve_overlap_);
+        local_solve_max_cell_fraction_ = param.getDefault("local_solve_max_cell_fraction", local_solve_max_cell_fraction_);
+        sequential_implicit_ = param.getDefault("sequential_implicit", sequential_implicit_);
+        sequential_max_transport_iter_ = param.getDefault("sequential_max_transport_iter", sequential_max_transport_iter_);
     }
 
 
@@ -64,7 +72,15 @@ namespace Opm
         tolerance_cnv_   = 1.0e-2;
         tolerance_wells_ = 1.0e-3;
         solve_welleq_initially_ = true;
+        local_well_solver_ = true;
+        well_only_iterations_ = false;
         update_equations_scaling_ = false;
+        extrapolate_initial_guess_ = false;
+        local_solve_max_iter_ = 0;
+        local_solve_overlap_ = 1;
+        local_solve_max_cell_fraction_ = 0.1;
+        sequential_implicit_ = false;
+        sequential_max_transport_iter_ = 10;
     }
 
 
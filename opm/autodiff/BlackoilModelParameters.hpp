@@ -45,10 +45,36 @@ namespace Opm
 
         /// Solve well equation initially
         bool solve_welleq_initially_;
+        /// Solve the well equations well by well, with dense local
+        /// Jacobians, instead of for all wells at once.
+        bool local_well_solver_;
+        /// When only the well equations are unconverged, solve them with
+        /// the reservoir fixed instead of doing a global Newton update.
+        /// Off by default.
+        bool well_only_iterations_;
 
         /// Update scaling factors for mass balance equations
         bool update_equations_scaling_;
 
+        /// Extrapolate the initial guess of a time step from the two
+        /// last accepted states.
+        bool extrapolate_initial_guess_;
+
+        /// Max number of local Newton iterations on the unconverged cells
+        /// between two global iterations, zero disables the local solves.
+        int local_solve_max_iter_;
+        /// Number of layers of neighbouring cells added to the unconverged cells.
+        int local_solve_overlap_;
+        /// Max fraction of all cells for which local solves are done.
+        double local_solve_max_cell_fraction_;
+
+        /// Use a sequential implicit scheme: in each nonlinear iteration,
+        /// solve for pressure and well variables, then for the transported
+        /// quantities at fixed pressure. Only supported in serial runs.
+        bool sequential_implicit_;
+        /// Max number of transport iterations in each sequential iteration.
+        int sequential_max_transport_iter_;
+
         /// Construct from user parameters or defaults.
         explicit BlackoilModelParameters( const parameter::ParameterGroup& param );
 
@@ -23,6 +23,7 @@
 #include <opm/core/simulator/BlackoilState.hpp>
 #include <opm/autodiff/BlackoilModelBase.hpp>
 #include <opm/autodiff/BlackoilModelParameters.hpp>
+#include <opm/autodiff/IndexedRowSum.hpp>
 #include <opm/autodiff/WellStateMultiSegment.hpp>
 #include <opm/autodiff/WellMultiSegment.hpp>
 
@@ -192,18 +193,18 @@ namespace Opm {
 
         // Well operations and data needed.
         struct MultiSegmentWellOps {
-            explicit MultiSegmentWellOps(const std::vector<WellMultiSegmentConstPtr>& wells_ms);
-            Eigen::SparseMatrix<double> w2p;              // well -> perf (scatter)
-            Eigen::SparseMatrix<double> p2w;              // perf -> well (gather)
-            Eigen::SparseMatrix<double> w2s;              // well -> segment (scatter)
-            Eigen::SparseMatrix<double> s2w;              // segment -> well (gather)
-            Eigen::SparseMatrix<double> s2p;              // segment -> perf (scatter)
-            Eigen::SparseMatrix<double> p2s;              // perf -> segment (gather)
-            Eigen::SparseMatrix<double> s2s_inlets;       // segment -> its inlet segments
-            Eigen::SparseMatrix<double> s2s_outlet;       // segment -> its outlet segment
-            Eigen::SparseMatrix<double> topseg2w;         // top segment -> well
+            MultiSegmentWellOps(const std::vector<WellMultiSegmentConstPtr>& wells_ms, const int num_cells);
+            IndexedRowSum w2p;                            // well -> perf (scatter)
+            IndexedRowSum w2s;                            // well -> segment (scatter)
+            IndexedRowSum s2p;                            // segment -> perf (scatter)
+            IndexedRowSum p2s;                            // perf -> segment (gather)
+            IndexedRowSum s2s_inlets;                     // segment -> its inlet segments
+            IndexedRowSum s2s_outlet;                     // segment -> its outlet segment
+            IndexedRowSum topseg2w;                       // top segment -> well
             AutoDiffMatrix eliminate_topseg;              // change the top segment related to be zero
+            std::vector<int> segment_outlets;             // outlet of each segment, -1 for the top segments
             std::vector<int> well_cells;                  // the set of perforated cells
+            IndexedRowSum c2p;                            // cell -> perf (gather from well_cells)
             V conn_trans_factors;                         // connection transmissibility factors
             bool has_multisegment_wells;                  // flag indicating whether there is any muli-segment well
         };
@@ -215,6 +216,7 @@ namespace Opm {
         // TODO: remove this wells structure
         using Base::wells;
         using Base::updatePrimalVariableFromState;
+        using Base::updatePoreVolumeOverDt;
         using Base::wellsActive;
         using Base::phaseCondition;
         using Base::fluidRvSat;
@@ -251,6 +253,18 @@ namespace Opm {
                     SolutionState& state,
                     WellState& well_state);
 
+        /// The segment variables are not handled by solveWellEqLocal().
+        bool canSolveWellEqLocal() const { return false; }
+
+        /// Solve the linearised segment equations with SegmentTreeSolver,
+        /// in time linear in the number of segments.
+        V solveWellLinearSystem(const ADB& total_residual) const;
+
+        /// The segment variables are not frozen by the base class
+        /// version, so the transport steps use the full assembly.
+        void assembleTransportEq(const ReservoirState& reservoir_state,
+                                 WellState& well_state);
+
         void
         computeWellFlux(const SolutionState& state,
                         const std::vector<ADB>& mob_perfcells,
@@ -27,6 +27,7 @@
 #include <opm/autodiff/GridHelpers.hpp>
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/GeoProps.hpp>
+#include <opm/autodiff/SegmentTreeSolver.hpp>
 #include <opm/autodiff/WellDensitySegmented.hpp>
 #include <opm/autodiff/VFPProperties.hpp>
 #include <opm/autodiff/VFPProdProperties.hpp>
@@ -96,7 +97,7 @@ namespace Opm {
         , segment_mass_flow_rates_(ADB::null())
         , segment_viscosities_(ADB::null())
         , wells_multisegment_(wells_multisegment)
-        , wops_ms_(wells_multisegment)
+        , wops_ms_(wells_multisegment, Opm::AutoDiffGrid::numCells(grid))
     {
     }
 
@@ -107,12 +108,14 @@ namespace Opm {
 
     template <class Grid>
     BlackoilMultiSegmentModel<Grid>::
-    MultiSegmentWellOps::MultiSegmentWellOps(const std::vector<WellMultiSegmentConstPtr>& wells_ms)
+    MultiSegmentWellOps::MultiSegmentWellOps(const std::vector<WellMultiSegmentConstPtr>& wells_ms,
+                                             const int num_cells)
     {
         // no multi-segment wells are involved by default.
         has_multisegment_wells = false;
 
         if (wells_ms.empty()) {
+            c2p = IndexedRowSum::gather(num_cells, well_cells);
             return;
         }
 
@@ -141,77 +144,63 @@ namespace Opm {
         }
         assert(well_perf_start == total_nperf);
         assert(int(well_cells.size()) == total_nperf);
-
-        // Create all the operator matrices,
-        // using the setFromTriplets() method.
-        s2s_inlets = Eigen::SparseMatrix<double>(total_nseg, total_nseg);
-        s2s_outlet = Eigen::SparseMatrix<double>(total_nseg, total_nseg);
-        s2w        = Eigen::SparseMatrix<double>(nw, total_nseg);
-        w2s        = Eigen::SparseMatrix<double>(total_nseg, nw);
-        topseg2w   = Eigen::SparseMatrix<double>(nw, total_nseg);
-        s2p = Eigen::SparseMatrix<double>(total_nperf, total_nseg);
-        p2s = Eigen::SparseMatrix<double>(total_nseg, total_nperf);
-        typedef Eigen::Triplet<double> Tri;
-        std::vector<Tri> s2s_inlets_vector;
-        std::vector<Tri> s2s_outlet_vector;
-        std::vector<Tri> s2w_vector;
-        std::vector<Tri> w2s_vector;
-        std::vector<Tri> topseg2w_vector;
-        std::vector<Tri> s2p_vector;
-        std::vector<Tri> p2s_vector;
+        c2p = IndexedRowSum::gather(num_cells, well_cells);
+
+        // Create the index arrays of all the operators.
+        // The summing operators p2s and s2s_inlets are stored by segment,
+        // the others are gathers with one entry per row.
+        std::vector<int> perf_segment(total_nperf, -1);
+        std::vector<int> perf_well(total_nperf);
+        std::vector<int> segment_well(total_nseg);
+        std::vector<int> top_segment(nw);
+        std::vector<int> p2s_starts(1, 0);
+        std::vector<int> p2s_sources;
+        std::vector<int> inlet_starts(1, 0);
+        std::vector<int> inlet_sources;
+        p2s_starts.reserve(total_nseg + 1);
+        p2s_sources.reserve(total_nperf);
+        inlet_starts.reserve(total_nseg + 1);
+        inlet_sources.reserve(total_nseg);
         V topseg_zero = V::Ones(total_nseg);
-        s2s_inlets_vector.reserve(total_nseg);
-        s2s_outlet_vector.reserve(total_nseg);
-        s2w_vector.reserve(total_nseg);
-        w2s_vector.reserve(total_nseg);
-        topseg2w_vector.reserve(nw);
-        s2p_vector.reserve(total_nperf);
-        p2s_vector.reserve(total_nperf);
+        segment_outlets.assign(total_nseg, -1);
         int seg_start = 0;
         int perf_start = 0;
         for (int w = 0; w < nw; ++w) {
             const int ns = wells_ms[w]->numberOfSegments();
             const int np = wells_ms[w]->numberOfPerforations();
+            top_segment[w] = seg_start;
+            topseg_zero(seg_start) = 0.0;
+            std::fill(perf_well.begin() + perf_start, perf_well.begin() + perf_start + np, w);
             for (int seg = 0; seg < ns; ++seg) {
                 const int seg_ind = seg_start + seg;
-                w2s_vector.push_back(Tri(seg_ind, w, 1.0));
-                s2w_vector.push_back(Tri(w, seg_ind, 1.0));
-                if (seg == 0) {
-                    topseg2w_vector.push_back(Tri(w, seg_ind, 1.0));
-                    topseg_zero(seg_ind) = 0.0;
-                }
-                int seg_outlet = wells_ms[w]->outletSegment()[seg];
+                segment_well[seg_ind] = w;
+                const int seg_outlet = wells_ms[w]->outletSegment()[seg];
                 if (seg_outlet >= 0) {
-                    const int outlet_ind = seg_start + seg_outlet;
-                    s2s_inlets_vector.push_back(Tri(outlet_ind, seg_ind, 1.0));
-                    s2s_outlet_vector.push_back(Tri(seg_ind, outlet_ind, 1.0));
+                    segment_outlets[seg_ind] = seg_start + seg_outlet;
+                }
+                for (const int inlet : wells_ms[w]->inletSegments()[seg]) {
+                    inlet_sources.push_back(seg_start + inlet);
                 }
+                inlet_starts.push_back(inlet_sources.size());
 
-                const auto& seg_perf = wells_ms[w]->segmentPerforations()[seg];
-                // the number of perforations related to this segment
-                const int npseg = seg_perf.size();
-                for (int perf = 0; perf < npseg; ++perf) {
-                    const int perf_ind = perf_start + seg_perf[perf];
-                    s2p_vector.push_back(Tri(perf_ind, seg_ind, 1.0));
-                    p2s_vector.push_back(Tri(seg_ind, perf_ind, 1.0));
+                for (const int perf : wells_ms[w]->segmentPerforations()[seg]) {
+                    const int perf_ind = perf_start + perf;
+                    perf_segment[perf_ind] = seg_ind;
+                    p2s_sources.push_back(perf_ind);
                 }
+                p2s_starts.push_back(p2s_sources.size());
             }
             seg_start += ns;
             perf_start += np;
         }
 
-        s2s_inlets.setFromTriplets(s2s_inlets_vector.begin(), s2s_inlets_vector.end());
-        s2s_outlet.setFromTriplets(s2s_outlet_vector.begin(), s2s_outlet_vector.end());
-        w2s.setFromTriplets(w2s_vector.begin(), w2s_vector.end());
-        s2w.setFromTriplets(s2w_vector.begin(), s2w_vector.end());
-        topseg2w.setFromTriplets(topseg2w_vector.begin(), topseg2w_vector.end());
-        s2p.setFromTriplets(s2p_vector.begin(), s2p_vector.end());
-        p2s.setFromTriplets(p2s_vector.begin(), p2s_vector.end());
-
-        w2p = Eigen::SparseMatrix<double>(total_nperf, nw);
-        p2w = Eigen::SparseMatrix<double>(nw, total_nperf);
-        w2p = s2p * w2s;
-        p2w = s2w * p2s;
+        s2s_inlets = IndexedRowSum(total_nseg, std::move(inlet_starts), std::move(inlet_sources));
+        s2s_outlet = IndexedRowSum::gather(total_nseg, segment_outlets);
+        w2s = IndexedRowSum::gather(nw, segment_well);
+        topseg2w = IndexedRowSum::gather(total_nseg, top_segment);
+        s2p = IndexedRowSum::gather(total_nseg, perf_segment);
+        p2s = IndexedRowSum(total_nperf, std::move(p2s_starts), std::move(p2s_sources));
+        w2p = IndexedRowSum::gather(nw, perf_well);
 
         eliminate_topseg = AutoDiffMatrix(topseg_zero.matrix().asDiagonal());
     }
@@ -228,7 +217,7 @@ namespace Opm {
                 ReservoirState& reservoir_state,
                 WellState& well_state)
     {
-        pvdt_ = geo_.poreVolume() / dt;
+        updatePoreVolumeOverDt(dt);
         if (active_[Gas]) {
             updatePrimalVariableFromState(reservoir_state);
         }
@@ -405,7 +394,7 @@ namespace Opm {
         assert(start_segment == xw.numSegments());
 
         // Use cell values for the temperature as the wells don't knows its temperature yet.
-        const ADB perf_temp = subset(state.temperature, well_cells);
+        const ADB perf_temp = wops_ms_.c2p * state.temperature;
 
         // Compute b, rsmax, rvmax values for perforations.
         // Evaluate the properties using average well block pressures
@@ -425,16 +414,16 @@ namespace Opm {
             b.col(pu.phase_pos[BlackoilPhases::Aqua]) = bw;
         }
         assert(active_[Oil]);
-        const V perf_so =  subset(state.saturation[pu.phase_pos[Oil]].value(), well_cells);
+        const V perf_so =  wops_ms_.c2p * state.saturation[pu.phase_pos[Oil]].value();
         if (pu.phase_used[BlackoilPhases::Liquid]) {
-            const ADB perf_rs = subset(state.rs, well_cells);
+            const ADB perf_rs = wops_ms_.c2p * state.rs;
             const V bo = fluid_.bOil(avg_press_ad, perf_temp, perf_rs, perf_cond, well_cells).value();
             b.col(pu.phase_pos[BlackoilPhases::Liquid]) = bo;
             const V rssat = fluidRsSat(avg_press, perf_so, well_cells);
             rsmax_perf.assign(rssat.data(), rssat.data() + nperf_total);
         }
         if (pu.phase_used[BlackoilPhases::Vapour]) {
-            const ADB perf_rv = subset(state.rv, well_cells);
+            const ADB perf_rv = wops_ms_.c2p * state.rv;
             const V bg = fluid_.bGas(avg_press_ad, perf_temp, perf_rv, perf_cond, well_cells).value();
             b.col(pu.phase_pos[BlackoilPhases::Vapour]) = bg;
             const V rvsat = fluidRvSat(avg_press, perf_so, well_cells);
@@ -444,7 +433,7 @@ namespace Opm {
         std::vector<double> b_perf(b.data(), b.data() + nperf_total * pu.num_phases);
         // Extract well connection depths.
         const V depth = cellCentroidsZToEigen(grid_);
-        const V perfcelldepth = subset(depth, well_cells);
+        const V perfcelldepth = wops_ms_.c2p * depth;
         std::vector<double> perf_cell_depth(perfcelldepth.data(), perfcelldepth.data() + nperf_total);
 
         // Surface density.
@@ -487,7 +476,7 @@ namespace Opm {
         std::vector<V> perf_kr;
         for(size_t i = 0; i < temp_size; ++i) {
             // const ADB kr_phase_adb = subset(kr_adb[i], well_cells);
-            const V kr_phase = (subset(kr_adb[i], well_cells)).value();
+            const V kr_phase = wops_ms_.c2p * kr_adb[i].value();
             perf_kr.push_back(kr_phase);
         }
 
@@ -512,7 +501,7 @@ namespace Opm {
         for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
             const int canonicalPhaseIdx = canph_[phaseIdx];
             const ADB fluid_density = fluidDensity(canonicalPhaseIdx, rq_[phaseIdx].b, state.rs, state.rv);
-            const V rho_perf = subset(fluid_density, well_cells).value();
+            const V rho_perf = wops_ms_.c2p * fluid_density.value();
             // TODO: phaseIdx or canonicalPhaseIdx ?
             rho_avg_perf += rho_perf * perf_kr[phaseIdx];
         }
@@ -564,6 +553,19 @@ namespace Opm {
 
 
 
+    template <class Grid>
+    void
+    BlackoilMultiSegmentModel<Grid>::
+    assembleTransportEq(const ReservoirState& reservoir_state,
+                        WellState& well_state)
+    {
+        assemble(reservoir_state, well_state, false);
+    }
+
+
+
+
+
     template <class Grid>
     void
     BlackoilMultiSegmentModel<Grid>::
@@ -675,13 +677,12 @@ namespace Opm {
 
         {
             const V& Tw = wops_ms_.conn_trans_factors;
-            const std::vector<int>& well_cells = wops_ms_.well_cells;
 
             // determining in-flow (towards well-bore) or out-flow (towards reservoir)
             // for mutli-segmented wells and non-segmented wells, the calculation of the drawdown are different.
-            const ADB& p_perfcells = subset(state.pressure, well_cells);
-            const ADB& rs_perfcells = subset(state.rs, well_cells);
-            const ADB& rv_perfcells = subset(state.rv, well_cells);
+            const ADB& p_perfcells = wops_ms_.c2p * state.pressure;
+            const ADB& rs_perfcells = wops_ms_.c2p * state.rs;
+            const ADB& rv_perfcells = wops_ms_.c2p * state.rv;
 
             const ADB& seg_pressures = state.segp;
 
@@ -693,7 +694,7 @@ namespace Opm {
                 is_multisegment_well[w] = double(wellsMultiSegment()[w]->isMultiSegmented());
             }
             // Take one flag per well and expand to one flag per perforation.
-            V is_multisegment_perf = wops_ms_.w2p * is_multisegment_well.matrix();
+            V is_multisegment_perf = wops_ms_.w2p * is_multisegment_well;
             Selector<double> msperf_selector(is_multisegment_perf, Selector<double>::NotEqualZero);
 
             // Compute drawdown.
@@ -1071,6 +1072,69 @@ namespace Opm {
 
 
 
+    template <class Grid>
+    V
+    BlackoilMultiSegmentModel<Grid>::solveWellLinearSystem(const ADB& total_residual) const
+    {
+        // The unknowns and the equations are the segment rates, phase
+        // by phase, followed by the segment pressures, so entry i
+        // belongs to segment i % nseg_total. The tree solver orders
+        // them segment by segment instead.
+        const std::vector<int>& outlet = wops_ms_.segment_outlets;
+        const int nseg_total = outlet.size();
+        const int block_size = numPhases() + 1;
+        const int n = total_residual.size();
+        if (nseg_total == 0 || n != nseg_total * block_size) {
+            return Base::solveWellLinearSystem(total_residual);
+        }
+
+        typedef Eigen::SparseMatrix<double> Sp;
+        Sp J;
+        total_residual.derivative()[0].toSparse(J);
+        SegmentTreeSolver solver(outlet, block_size);
+        for (int col = 0; col < J.outerSize(); ++col) {
+            const int col_seg = col % nseg_total;
+            for (Sp::InnerIterator it(J, col); it; ++it) {
+                const int row = it.row();
+                const int row_seg = row % nseg_total;
+                SegmentTreeSolver::Block* block = nullptr;
+                if (row_seg == col_seg) {
+                    block = &solver.diagonal(row_seg);
+                } else if (outlet[row_seg] == col_seg) {
+                    block = &solver.toOutlet(row_seg);
+                } else if (outlet[col_seg] == row_seg) {
+                    block = &solver.fromOutlet(col_seg);
+                } else {
+                    // Coupling between segments that are not neighbours.
+                    return Base::solveWellLinearSystem(total_residual);
+                }
+                (*block)(row / nseg_total, col / nseg_total) += it.value();
+            }
+        }
+        solver.factorize();
+
+        const V& res = total_residual.value();
+        Eigen::VectorXd x(n);
+        for (int i = 0; i < n; ++i) {
+            x[(i % nseg_total) * block_size + i / nseg_total] = res[i];
+        }
+        solver.solve(x);
+        if (!x.allFinite()) {
+            // Singular segment blocks, let the sparse solver deal with it.
+            return Base::solveWellLinearSystem(total_residual);
+        }
+
+        V dx(n);
+        for (int i = 0; i < n; ++i) {
+            dx[i] = x[(i % nseg_total) * block_size + i / nseg_total];
+        }
+        return dx;
+    }
+
+
+
+
+
     template <class Grid>
     void BlackoilMultiSegmentModel<Grid>::addWellControlEq(const SolutionState& state,
                                                            const WellState& xw,
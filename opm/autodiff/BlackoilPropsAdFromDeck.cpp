@@ -36,6 +36,8 @@
 
 #include <opm/common/ErrorMacros.hpp>
 
+#include <algorithm>
+
 namespace Opm
 {
     // Making these typedef to make the code more readable.
@@ -43,6 +45,88 @@ namespace Opm
     typedef BlackoilPropsAdFromDeck::V V;
     typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Block;
 
+    namespace
+    {
+        // Number of cells handed to the saturation functions at a time
+        // when they are evaluated by several threads.
+        const int satfunc_chunk_size = 1024;
+
+        // Call eval(begin, count) for consecutive chunks of the cells
+        // [0, num_cells), in parallel.
+        template <class Eval>
+        void forEachCellChunk(const int num_cells, const Eval& eval)
+        {
+            const int num_chunks = (num_cells + satfunc_chunk_size - 1) / satfunc_chunk_size;
+#pragma omp parallel for schedule(static)
+            for (int chunk = 0; chunk < num_chunks; ++chunk) {
+                const int begin = chunk * satfunc_chunk_size;
+                eval(begin, std::min(satfunc_chunk_size, num_cells - begin));
+            }
+        }
+
+        // Build the ADBs of the saturation functions f (relperm or
+        // capillary pressure) from their values and their derivatives
+        // df/ds, as returned by SaturationPropsInterface (Fortran
+        // ordering of the derivatives). Pairs of phases where either
+        // df1/ds2 or the derivatives of s2 are zero are skipped, and
+        // the Jacobian blocks are assembled in parallel.
+        std::vector<ADB> saturationFunctionADBs(const PhaseUsage& pu,
+                                                const Block& f,
+                                                const Block& df_ds,
+                                                const ADB* const s[3])
+        {
+            const int n = f.rows();
+            const int np = pu.num_phases;
+            const int num_blocks = s[BlackoilPropsAdInterface::Oil]->numBlocks();
+            std::vector<ADB> result;
+            result.reserve(3);
+            for (int phase1 = 0; phase1 < 3; ++phase1) {
+                if (!pu.phase_used[phase1]) {
+                    result.emplace_back(ADB::null());
+                    continue;
+                }
+                const int phase1_pos = pu.phase_pos[phase1];
+                std::vector<ADB::M> diags;
+                std::vector<int> phase2s;
+                for (int phase2 = 0; phase2 < 3; ++phase2) {
+                    if (!pu.phase_used[phase2]) {
+                        continue;
+                    }
+                    const int column = phase1_pos + np*pu.phase_pos[phase2]; // Recall: Fortran ordering.
+                    if ((df_ds.col(column) != 0.0).any()) {
+                        diags.emplace_back(ADB::M(df_ds.col(column).matrix().asDiagonal()));
+                        phase2s.push_back(phase2);
+                    }
+                }
+                std::vector<ADB::M> jacs(num_blocks);
+#pragma omp parallel for schedule(dynamic)
+                for (int block = 0; block < num_blocks; ++block) {
+                    bool assigned = false;
+                    for (size_t k = 0; k < phase2s.size(); ++k) {
+                        const ADB::M& ds2 = s[phase2s[k]]->derivative()[block];
+                        if (ds2.nonZeros() == 0) {
+                            continue;
+                        }
+                        ADB::M temp;
+                        fastSparseProduct(diags[k], ds2, temp);
+                        if (assigned) {
+                            jacs[block] += temp;
+                        } else {
+                            jacs[block] = std::move(temp);
+                            assigned = true;
+                        }
+                    }
+                    if (!assigned) {
+                        jacs[block] = ADB::M(n, s[phase1]->derivative()[block].cols());
+                    }
+                }
+                ADB::V val = f.col(phase1_pos);
+                result.emplace_back(ADB::function(std::move(val), std::move(jacs)));
+            }
+            return result;
+        }
+    } // anonymous namespace
+
     /// Constructor wrapping an opm-core black oil interface.
     BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(Opm::DeckConstPtr deck,
                                                      Opm::EclipseStateConstPtr eclState,
@@ -137,6 +221,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
     // For data that is dependant on the subgrid we simply allocate space
     // and initialize with obviously bogus numbers.
     cellPvtRegionIdx_.resize(number_of_cells, std::numeric_limits<int>::min());
+    setPvtCacheTolerance(props.pvt_cache_tolerance_);
     satprops_->init(phase_usage_, materialLawManager_);
 }
 
@@ -211,6 +296,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
                       << ") and saturation-dependent function data (" << satprops_->numPhases() << ").");
         }
         vap_satmax_guard_ = 0.01;
+        pvt_cache_tolerance_ = -1.0;
     }
 
     ////////////////////////////
@@ -309,15 +395,31 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pLad.derivatives[0] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = pw.value()[i];
-            TLad.value = T.value()[i];
+        // Water properties do not depend on r, so the saturated branch
+        // of the cache is used throughout.
+        PvtPointCache* cache = pvtCache(MuWatCache);
+        double unused_dr;
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                if (cache && cache->lookup(cell, pw.value()[i], T.value()[i], 0.0, true,
+                                           pvt_cache_tolerance_, mu[i], dmudp[i], unused_dr)) {
+                    continue;
+                }
+                pLad.value = pw.value()[i];
+                TLad.value = T.value()[i];
 
-            const LadEval& muLad = waterPvt_->viscosity(pvtRegionIdx, TLad, pLad);
+                const LadEval& muLad = waterPvt_->viscosity(pvtRegionIdx, TLad, pLad);
 
-            mu[i] = muLad.value;
-            dmudp[i] = muLad.derivatives[0];
+                mu[i] = muLad.value;
+                dmudp[i] = muLad.derivatives[0];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, 0.0, true, mu[i], dmudp[i], 0.0);
+                }
+            }
         }
 
         if (pw.derivative().empty()) {
@@ -366,22 +468,37 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         RsLad.derivatives[1] = 1.0;
 
         LadEval muLad;
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = po.value()[i];
-            TLad.value = T.value()[i];
+        PvtPointCache* cache = pvtCache(MuOilCache);
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                const bool saturated = cond[i].hasFreeGas();
+                if (cache && cache->lookup(cell, po.value()[i], T.value()[i], rs.value()[i], saturated,
+                                           pvt_cache_tolerance_, mu[i], dmudp[i], dmudr[i])) {
+                    continue;
+                }
+                pLad.value = po.value()[i];
+                TLad.value = T.value()[i];
 
-            if (cond[i].hasFreeGas()) {
-                muLad = oilPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
-            }
-            else {
-                RsLad.value = rs.value()[i];
-                muLad = oilPvt_->viscosity(pvtRegionIdx, TLad, pLad, RsLad);
-            }
+                if (saturated) {
+                    muLad = oilPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
+                }
+                else {
+                    RsLad.value = rs.value()[i];
+                    muLad = oilPvt_->viscosity(pvtRegionIdx, TLad, pLad, RsLad);
+                }
 
-            mu[i] = muLad.value;
-            dmudp[i] = muLad.derivatives[0];
-            dmudr[i] = muLad.derivatives[1];
+                mu[i] = muLad.value;
+                dmudp[i] = muLad.derivatives[0];
+                dmudr[i] = muLad.derivatives[1];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, rs.value()[i], saturated,
+                                 mu[i], dmudp[i], dmudr[i]);
+                }
+            }
         }
 
         ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
@@ -430,22 +547,37 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pLad.derivatives[0] = 1.0;
         RvLad.derivatives[1] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = pg.value()[i];
-            TLad.value = T.value()[i];
+        PvtPointCache* cache = pvtCache(MuGasCache);
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                const bool saturated = cond[i].hasFreeOil();
+                if (cache && cache->lookup(cell, pg.value()[i], T.value()[i], rv.value()[i], saturated,
+                                           pvt_cache_tolerance_, mu[i], dmudp[i], dmudr[i])) {
+                    continue;
+                }
+                pLad.value = pg.value()[i];
+                TLad.value = T.value()[i];
 
-            if (cond[i].hasFreeOil()) {
-                muLad = gasPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
-            }
-            else {
-                RvLad.value = rv.value()[i];
-                muLad = gasPvt_->viscosity(pvtRegionIdx, TLad, pLad, RvLad);
-            }
+                if (saturated) {
+                    muLad = gasPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
+                }
+                else {
+                    RvLad.value = rv.value()[i];
+                    muLad = gasPvt_->viscosity(pvtRegionIdx, TLad, pLad, RvLad);
+                }
 
-            mu[i] = muLad.value;
-            dmudp[i] = muLad.derivatives[0];
-            dmudr[i] = muLad.derivatives[1];
+                mu[i] = muLad.value;
+                dmudp[i] = muLad.derivatives[0];
+                dmudr[i] = muLad.derivatives[1];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, rv.value()[i], saturated,
+                                 mu[i], dmudp[i], dmudr[i]);
+                }
+            }
         }
 
         ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
@@ -491,15 +623,32 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         LadEval TLad = 0.0;
 
         pLad.derivatives[0] = 1.0;
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = pw.value()[i];
-            TLad.value = T.value()[i];
 
-            const LadEval& bLad = waterPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+        // Water properties do not depend on r, so the saturated branch
+        // of the cache is used throughout.
+        PvtPointCache* cache = pvtCache(BWatCache);
+        double unused_dr;
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                if (cache && cache->lookup(cell, pw.value()[i], T.value()[i], 0.0, true,
+                                           pvt_cache_tolerance_, b[i], dbdp[i], unused_dr)) {
+                    continue;
+                }
+                pLad.value = pw.value()[i];
+                TLad.value = T.value()[i];
+
+                const LadEval& bLad = waterPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
 
-            b[i] = bLad.value;
-            dbdp[i] = bLad.derivatives[0];
+                b[i] = bLad.value;
+                dbdp[i] = bLad.derivatives[0];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, 0.0, true, b[i], dbdp[i], 0.0);
+                }
+            }
         }
 
         ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
@@ -545,22 +694,37 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pLad.derivatives[0] = 1.0;
         RsLad.derivatives[1] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = po.value()[i];
-            TLad.value = T.value()[i];
+        PvtPointCache* cache = pvtCache(BOilCache);
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                const bool saturated = cond[i].hasFreeGas();
+                if (cache && cache->lookup(cell, po.value()[i], T.value()[i], rs.value()[i], saturated,
+                                           pvt_cache_tolerance_, b[i], dbdp[i], dbdr[i])) {
+                    continue;
+                }
+                pLad.value = po.value()[i];
+                TLad.value = T.value()[i];
 
-            if (cond[i].hasFreeGas()) {
-                bLad = oilPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
-            }
-            else {
-                RsLad.value = rs.value()[i];
-                bLad = oilPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RsLad);
-            }
+                if (saturated) {
+                    bLad = oilPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+                }
+                else {
+                    RsLad.value = rs.value()[i];
+                    bLad = oilPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RsLad);
+                }
 
-            b[i] = bLad.value;
-            dbdp[i] = bLad.derivatives[0];
-            dbdr[i] = bLad.derivatives[1];
+                b[i] = bLad.value;
+                dbdp[i] = bLad.derivatives[0];
+                dbdr[i] = bLad.derivatives[1];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, rs.value()[i], saturated,
+                                 b[i], dbdp[i], dbdr[i]);
+                }
+            }
         }
 
         ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
@@ -610,22 +774,37 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         pLad.derivatives[0] = 1.0;
         RvLad.derivatives[1] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = pg.value()[i];
-            TLad.value = T.value()[i];
+        PvtPointCache* cache = pvtCache(BGasCache);
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                const bool saturated = cond[i].hasFreeOil();
+                if (cache && cache->lookup(cell, pg.value()[i], T.value()[i], rv.value()[i], saturated,
+                                           pvt_cache_tolerance_, b[i], dbdp[i], dbdr[i])) {
+                    continue;
+                }
+                pLad.value = pg.value()[i];
+                TLad.value = T.value()[i];
 
-            if (cond[i].hasFreeOil()) {
-                bLad = gasPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
-            }
-            else {
-                RvLad.value = rv.value()[i];
-                bLad = gasPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RvLad);
-            }
+                if (saturated) {
+                    bLad = gasPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+                }
+                else {
+                    RvLad.value = rv.value()[i];
+                    bLad = gasPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RvLad);
+                }
 
-            b[i] = bLad.value;
-            dbdp[i] = bLad.derivatives[0];
-            dbdr[i] = bLad.derivatives[1];
+                b[i] = bLad.value;
+                dbdp[i] = bLad.derivatives[0];
+                dbdr[i] = bLad.derivatives[1];
+                if (cache) {
+                    cache->store(cell, pLad.value, TLad.value, rv.value()[i], saturated,
+                                 b[i], dbdp[i], dbdr[i]);
+                }
+            }
         }
 
         ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
@@ -643,6 +822,168 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
 
 
+    /// Formation volume factor and viscosity of a phase, evaluated
+    /// together in a single pass over the cells.
+    void BlackoilPropsAdFromDeck::bAndMu(const int phase,
+                                         const ADB& p,
+                                         const ADB& T,
+                                         const ADB& rs,
+                                         const ADB& rv,
+                                         const std::vector<PhasePresence>& cond,
+                                         const Cells& cells,
+                                         ADB& b,
+                                         ADB& mu) const
+    {
+        if (phase != Water && phase != Oil && phase != Gas) {
+            OPM_THROW(std::runtime_error, "Unknown phase index " << phase);
+        }
+        if (!phase_usage_.phase_used[phase]) {
+            OPM_THROW(std::runtime_error, "Cannot call bAndMu(): phase " << phase << " not active.");
+        }
+        const int n = cells.size();
+        assert(p.size() == n);
+
+        // The dissolution factor the phase properties depend on.
+        const bool has_r = (phase != Water);
+        const ADB& r = (phase == Gas) ? rv : rs;
+
+        V bv(n);
+        V dbdp(n);
+        V dbdr = V::Zero(n);
+        V muv(n);
+        V dmudp(n);
+        V dmudr = V::Zero(n);
+
+        enum PressureREvalTag {};
+        typedef Opm::LocalAd::Evaluation<double, PressureREvalTag, /*size=*/2> LadEval;
+
+        LadEval pLad = 0.0;
+        LadEval TLad = 0.0;
+        LadEval RLad = 0.0;
+        LadEval bLad;
+        LadEval muLad;
+
+        pLad.derivatives[0] = 1.0;
+        RLad.derivatives[1] = 1.0;
+
+        PvtPointCache* b_cache = pvtCache(phase == Water ? BWatCache : (phase == Oil ? BOilCache : BGasCache));
+        PvtPointCache* mu_cache = pvtCache(phase == Water ? MuWatCache : (phase == Oil ? MuOilCache : MuGasCache));
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int reg = 0; reg < ordering.numRegions(); ++reg) {
+            const unsigned pvtRegionIdx = ordering.region[reg];
+            for (int k = ordering.start[reg]; k < ordering.start[reg + 1]; ++k) {
+                const int i = ordering.index(k);
+                const int cell = cells[i];
+                // Water properties do not depend on r, and use the
+                // saturated branch of the caches.
+                const bool saturated = (phase == Water)
+                    || (phase == Oil && cond[i].hasFreeGas())
+                    || (phase == Gas && cond[i].hasFreeOil());
+                const double r_i = has_r ? r.value()[i] : 0.0;
+                const bool b_cached = b_cache
+                    && b_cache->lookup(cell, p.value()[i], T.value()[i], r_i, saturated,
+                                       pvt_cache_tolerance_, bv[i], dbdp[i], dbdr[i]);
+                const bool mu_cached = mu_cache
+                    && mu_cache->lookup(cell, p.value()[i], T.value()[i], r_i, saturated,
+                                        pvt_cache_tolerance_, muv[i], dmudp[i], dmudr[i]);
+                if (b_cached && mu_cached) {
+                    continue;
+                }
+                pLad.value = p.value()[i];
+                TLad.value = T.value()[i];
+                RLad.value = r_i;
+
+                switch (phase) {
+                case Water:
+                    if (!b_cached) {
+                        bLad = waterPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+                    }
+                    if (!mu_cached) {
+                        muLad = waterPvt_->viscosity(pvtRegionIdx, TLad, pLad);
+                    }
+                    break;
+                case Oil:
+                    if (saturated) {
+                        if (!b_cached) {
+                            bLad = oilPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+                        }
+                        if (!mu_cached) {
+                            muLad = oilPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
+                        }
+                    }
+                    else {
+                        if (!b_cached) {
+                            bLad = oilPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RLad);
+                        }
+                        if (!mu_cached) {
+                            muLad = oilPvt_->viscosity(pvtRegionIdx, TLad, pLad, RLad);
+                        }
+                    }
+                    break;
+                case Gas:
+                    if (saturated) {
+                        if (!b_cached) {
+                            bLad = gasPvt_->saturatedInverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad);
+                        }
+                        if (!mu_cached) {
+                            muLad = gasPvt_->saturatedViscosity(pvtRegionIdx, TLad, pLad);
+                        }
+                    }
+                    else {
+                        if (!b_cached) {
+                            bLad = gasPvt_->inverseFormationVolumeFactor(pvtRegionIdx, TLad, pLad, RLad);
+                        }
+                        if (!mu_cached) {
+                            muLad = gasPvt_->viscosity(pvtRegionIdx, TLad, pLad, RLad);
+                        }
+                    }
+                    break;
+                }
+
+                if (!b_cached) {
+                    bv[i] = bLad.value;
+                    dbdp[i] = bLad.derivatives[0];
+                    dbdr[i] = bLad.derivatives[1];
+                    if (b_cache) {
+                        b_cache->store(cell, pLad.value, TLad.value, r_i, saturated, bv[i], dbdp[i], dbdr[i]);
+                    }
+                }
+                if (!mu_cached) {
+                    muv[i] = muLad.value;
+                    dmudp[i] = muLad.derivatives[0];
+                    dmudr[i] = muLad.derivatives[1];
+                    if (mu_cache) {
+                        mu_cache->store(cell, pLad.value, TLad.value, r_i, saturated, muv[i], dmudp[i], dmudr[i]);
+                    }
+                }
+            }
+        }
+
+        ADB::M dbdp_diag(dbdp.matrix().asDiagonal());
+        ADB::M dmudp_diag(dmudp.matrix().asDiagonal());
+        ADB::M dbdr_diag(dbdr.matrix().asDiagonal());
+        ADB::M dmudr_diag(dmudr.matrix().asDiagonal());
+        const int num_blocks = p.numBlocks();
+        std::vector<ADB::M> jacs_b(num_blocks);
+        std::vector<ADB::M> jacs_mu(num_blocks);
+        for (int block = 0; block < num_blocks; ++block) {
+            fastSparseProduct(dbdp_diag, p.derivative()[block], jacs_b[block]);
+            fastSparseProduct(dmudp_diag, p.derivative()[block], jacs_mu[block]);
+            if (has_r) {
+                ADB::M temp_b;
+                fastSparseProduct(dbdr_diag, r.derivative()[block], temp_b);
+                jacs_b[block] += temp_b;
+                ADB::M temp_mu;
+                fastSparseProduct(dmudr_diag, r.derivative()[block], temp_mu);
+                jacs_mu[block] += temp_mu;
+            }
+        }
+        b = ADB::function(std::move(bv), std::move(jacs_b));
+        mu = ADB::function(std::move(muv), std::move(jacs_mu));
+    }
+
+
+
     // ------ Rs bubble point curve ------
 
     /// Bubble point curve for Rs as function of oil pressure.
@@ -668,14 +1009,18 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pLad.derivatives[0] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = po.value()[i];
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                pLad.value = po.value()[i];
 
-            const LadEval& RsLad = oilPvt_->saturatedGasDissolutionFactor(pvtRegionIdx, TLad, pLad);
+                const LadEval& RsLad = oilPvt_->saturatedGasDissolutionFactor(pvtRegionIdx, TLad, pLad);
 
-            rbub[i] = RsLad.value;
-            drbubdp[i] = RsLad.derivatives[0];
+                rbub[i] = RsLad.value;
+                drbubdp[i] = RsLad.derivatives[0];
+            }
         }
 
         ADB::M drbubdp_diag(drbubdp.matrix().asDiagonal());
@@ -726,14 +1071,18 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         pLad.derivatives[0] = 1.0;
 
-        for (int i = 0; i < n; ++i) {
-            unsigned pvtRegionIdx = cellPvtRegionIdx_[cells[i]];
-            pLad.value = pg.value()[i];
+        const PvtRegionOrdering ordering = regionOrdering(cells);
+        for (int r = 0; r < ordering.numRegions(); ++r) {
+            const unsigned pvtRegionIdx = ordering.region[r];
+            for (int k = ordering.start[r]; k < ordering.start[r + 1]; ++k) {
+                const int i = ordering.index(k);
+                pLad.value = pg.value()[i];
 
-            const LadEval& RvLad = gasPvt_->saturatedOilVaporizationFactor(pvtRegionIdx, TLad, pLad);
+                const LadEval& RvLad = gasPvt_->saturatedOilVaporizationFactor(pvtRegionIdx, TLad, pLad);
 
-            rv[i] = RvLad.value;
-            drvdp[i] = RvLad.derivatives[0];
+                rv[i] = RvLad.value;
+                drvdp[i] = RvLad.derivatives[0];
+            }
         }
 
         ADB::M drvdp_diag(drvdp.matrix().asDiagonal());
@@ -792,41 +1141,13 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         }
         Block kr(n, np);
         Block dkr(n, np*np);
-        satprops_->relperm(n, s_all.data(), cells.data(), kr.data(), dkr.data());
-        const int num_blocks = so.numBlocks();
-        std::vector<ADB> relperms;
-        relperms.reserve(3);
-        typedef const ADB* ADBPtr;
-        ADBPtr s[3] = { &sw, &so, &sg };
-        for (int phase1 = 0; phase1 < 3; ++phase1) {
-            if (phase_usage_.phase_used[phase1]) {
-                const int phase1_pos = phase_usage_.phase_pos[phase1];
-                std::vector<ADB::M> jacs(num_blocks);
-                for (int block = 0; block < num_blocks; ++block) {
-                    jacs[block] = ADB::M(n, s[phase1]->derivative()[block].cols());
-                }
-                for (int phase2 = 0; phase2 < 3; ++phase2) {
-                    if (!phase_usage_.phase_used[phase2]) {
-                        continue;
-                    }
-                    const int phase2_pos = phase_usage_.phase_pos[phase2];
-                    // Assemble dkr1/ds2.
-                    const int column = phase1_pos + np*phase2_pos; // Recall: Fortran ordering from props_.relperm()
-
-                    ADB::M dkr1_ds2_diag(dkr.col(column).matrix().asDiagonal());
-                    for (int block = 0; block < num_blocks; ++block) {
-                        ADB::M temp;
-                        fastSparseProduct(dkr1_ds2_diag, s[phase2]->derivative()[block], temp);
-                        jacs[block] += temp;
-                    }
-                }
-                ADB::V val = kr.col(phase1_pos);
-                relperms.emplace_back(ADB::function(std::move(val), std::move(jacs)));
-            } else {
-                relperms.emplace_back(ADB::null());
-            }
-        }
-        return relperms;
+        // The cells are independent, evaluate them in chunks in parallel.
+        forEachCellChunk(n, [&](const int begin, const int count) {
+                satprops_->relperm(count, s_all.data() + np*begin, cells.data() + begin,
+                                   kr.data() + np*begin, dkr.data() + np*np*begin);
+            });
+        const ADB* const s[3] = { &sw, &so, &sg };
+        return saturationFunctionADBs(phase_usage_, kr, dkr, s);
     }
 
     std::vector<ADB> BlackoilPropsAdFromDeck::capPress(const ADB& sw,
@@ -836,7 +1157,6 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
     {
         const int nCells = cells.size();
         const int nActivePhases = numPhases();
-        const int nBlocks = so.numBlocks();
 
         Block activeSat(nCells, nActivePhases);
         if (phase_usage_.phase_used[Water]) {
@@ -856,38 +1176,14 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
 
         Block pc(nCells, nActivePhases);
         Block dpc(nCells, nActivePhases*nActivePhases);
-        satprops_->capPress(nCells, activeSat.data(), cells.data(), pc.data(), dpc.data());
-
-        std::vector<ADB> adbCapPressures;
-        adbCapPressures.reserve(3);
-        const ADB* s[3] = { &sw, &so, &sg };
-        for (int phase1 = 0; phase1 < 3; ++phase1) {
-            if (phase_usage_.phase_used[phase1]) {
-                const int phase1_pos = phase_usage_.phase_pos[phase1];
-                std::vector<ADB::M> jacs(nBlocks);
-                for (int block = 0; block < nBlocks; ++block) {
-                    jacs[block] = ADB::M(nCells, s[phase1]->derivative()[block].cols());
-                }
-                for (int phase2 = 0; phase2 < 3; ++phase2) {
-                    if (!phase_usage_.phase_used[phase2])
-                        continue;
-                    const int phase2_pos = phase_usage_.phase_pos[phase2];
-                    // Assemble dpc1/ds2.
-                    const int column = phase1_pos + nActivePhases*phase2_pos; // Recall: Fortran ordering from props_.relperm()
-                    ADB::M dpc1_ds2_diag(dpc.col(column).matrix().asDiagonal());
-                    for (int block = 0; block < nBlocks; ++block) {
-                        ADB::M temp;
-                        fastSparseProduct(dpc1_ds2_diag, s[phase2]->derivative()[block], temp);
-                        jacs[block] += temp;
-                    }
-                }
-                ADB::V val = pc.col(phase1_pos);
-                adbCapPressures.emplace_back(ADB::function(std::move(val), std::move(jacs)));
-            } else {
-                adbCapPressures.emplace_back(ADB::null());
-            }
-        }
-        return adbCapPressures;
+        forEachCellChunk(nCells, [&](const int begin, const int count) {
+                satprops_->capPress(count, activeSat.data() + nActivePhases*begin, cells.data() + begin,
+                                    pc.data() + nActivePhases*begin,
+                                    dpc.data() + nActivePhases*nActivePhases*begin);
+            });
+
+        const ADB* const s[3] = { &sw, &so, &sg };
+        return saturationFunctionADBs(phase_usage_, pc, dpc, s);
     }
 
     /// Saturation update for hysteresis behavior.
@@ -896,7 +1192,10 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
                                                 const std::vector<int>& cells)
     {
         const int n = cells.size();
-        satprops_->updateSatHyst(n, cells.data(), saturation.data());
+        const int np = numPhases();
+        forEachCellChunk(n, [&](const int begin, const int count) {
+                satprops_->updateSatHyst(count, cells.data() + begin, saturation.data() + np*begin);
+            });
     }
 
     /// Update for max oil saturation.
@@ -907,6 +1206,7 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
             const int np = phase_usage_.num_phases;
             const int posOil = phase_usage_.phase_pos[Oil];
             const double* s = saturation.data();
+#pragma omp parallel for schedule(static)
             for (int i=0; i<n; ++i) {
                 if (satOilMax_[i] < s[np*i+posOil]) {
                     satOilMax_[i] = s[np*i+posOil];
@@ -989,6 +1289,74 @@ BlackoilPropsAdFromDeck::BlackoilPropsAdFromDeck(const BlackoilPropsAdFromDeck&
         }
     }
 
+    /// Enable reuse of PVT evaluations within a relative tolerance.
+    /// The caches are sized for all cells here, so that the evaluators
+    /// never resize them while they are used from parallel loops.
+    /// \param[in]  tol  Relative tolerance, a negative value disables the cache.
+    void BlackoilPropsAdFromDeck::setPvtCacheTolerance(const double tol)
+    {
+        pvt_cache_tolerance_ = tol;
+        const int nc = (tol < 0.0) ? 0 : cellPvtRegionIdx_.size();
+        for (auto& cache : pvt_cache_) {
+            cache.reset(nc);
+        }
+    }
+
+    /// Cache for the given quantity.
+    /// \return null if caching is disabled.
+    PvtPointCache* BlackoilPropsAdFromDeck::pvtCache(const PvtCacheQuantity quantity) const
+    {
+        if (pvt_cache_tolerance_ < 0.0) {
+            return nullptr;
+        }
+        return &pvt_cache_[quantity];
+    }
+
+    /// Ordering of the cells by PVT region, computed by a counting sort.
+    /// With a single region present no sorting is needed.
+    BlackoilPropsAdFromDeck::PvtRegionOrdering
+    BlackoilPropsAdFromDeck::regionOrdering(const Cells& cells) const
+    {
+        PvtRegionOrdering ordering;
+        const int n = cells.size();
+        if (n == 0) {
+            ordering.start.push_back(0);
+            return ordering;
+        }
+
+        int min_region = cellPvtRegionIdx_[cells[0]];
+        int max_region = min_region;
+        for (int i = 1; i < n; ++i) {
+            min_region = std::min(min_region, cellPvtRegionIdx_[cells[i]]);
+            max_region = std::max(max_region, cellPvtRegionIdx_[cells[i]]);
+        }
+        if (min_region == max_region) {
+            ordering.region.push_back(min_region);
+            ordering.start.push_back(0);
+            ordering.start.push_back(n);
+            return ordering;
+        }
+
+        const int num_regions = max_region + 1;
+        std::vector<int> count(num_regions + 1, 0);
+        for (int i = 0; i < n; ++i) {
+            ++count[cellPvtRegionIdx_[cells[i]] + 1];
+        }
+        for (int reg = 0; reg < num_regions; ++reg) {
+            if (count[reg + 1] > 0) {
+                ordering.region.push_back(reg);
+                ordering.start.push_back(count[reg]);
+            }
+            count[reg + 1] += count[reg];
+        }
+        ordering.start.push_back(n);
+        ordering.position.resize(n);
+        for (int i = 0; i < n; ++i) {
+            ordering.position[count[cellPvtRegionIdx_[cells[i]]]++] = i;
+        }
+        return ordering;
+    }
+
     /// Obtain the scaled critical oil in gas saturation values.
     /// \param[in]  cells  Array of cell indices.
     /// \return Array of critical oil in gas saturaion values.
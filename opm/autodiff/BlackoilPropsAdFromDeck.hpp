@@ -24,6 +24,7 @@
 
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/AutoDiffBlock.hpp>
+#include <opm/autodiff/PvtPointCache.hpp>
 
 #include <opm/core/props/BlackoilPhases.hpp>
 #include <opm/core/props/satfunc/SaturationPropsFromDeck.hpp>
@@ -277,6 +278,27 @@ namespace Opm
                  const std::vector<PhasePresence>& cond,
                  const Cells& cells) const;
 
+        /// Formation volume factor and viscosity of a phase, evaluated
+        /// together in a single pass over the cells.
+        /// \param[in]  phase  Phase index (Water, Oil or Gas).
+        /// \param[in]  p      Array of n phase pressure values.
+        /// \param[in]  T      Array of n temperature values.
+        /// \param[in]  rs     Array of n gas solution factor values, used for oil.
+        /// \param[in]  rv     Array of n vapor oil/gas ratios, used for gas.
+        /// \param[in]  cond   Array of n objects, each specifying which phases are present with non-zero saturation in a cell.
+        /// \param[in]  cells  Array of n cell indices to be associated with the pressure values.
+        /// \param[out] b      Array of n formation volume factor values.
+        /// \param[out] mu     Array of n viscosity values.
+        void bAndMu(const int phase,
+                    const ADB& p,
+                    const ADB& T,
+                    const ADB& rs,
+                    const ADB& rv,
+                    const std::vector<PhasePresence>& cond,
+                    const Cells& cells,
+                    ADB& b,
+                    ADB& mu) const;
+
         // ------ Rs bubble point curve ------
 
         /// Bubble point curve for Rs as function of oil pressure.
@@ -380,6 +402,14 @@ namespace Opm
         /// \return Array of scaled critical gas saturaion values.
         V scaledCriticalGasSaturations(const Cells& cells) const;
 
+        /// Enable reuse of the viscosity and formation volume factor
+        /// evaluations of cells whose pressure, temperature and rs/rv
+        /// have changed by less than a relative tolerance since they
+        /// were last evaluated. Reused values are extrapolated to first
+        /// order with the cached derivatives.
+        /// \param[in]  tol  Relative tolerance, a negative value disables the cache.
+        void setPvtCacheTolerance(const double tol);
+
 
     private:
         /// Initializes the properties.
@@ -402,6 +432,37 @@ namespace Opm
                       const std::vector<int>& cells,
                       const double vap) const;
 
+        /// The quantities held in pvt_cache_.
+        enum PvtCacheQuantity { MuWatCache, MuOilCache, MuGasCache,
+                                BWatCache, BOilCache, BGasCache,
+                                NumPvtCaches };
+
+        /// Cache for the given quantity, or null if caching is disabled.
+        PvtPointCache* pvtCache(const PvtCacheQuantity quantity) const;
+
+        /// A set of cells grouped by PVT region, so that the tables of
+        /// one region are used for a contiguous run of evaluations.
+        struct PvtRegionOrdering
+        {
+            /// Positions into the cells, grouped by region. Empty if all
+            /// cells are in the same region, in which case the cells are
+            /// visited in their given order.
+            std::vector<int> position;
+            /// The regions present, in increasing order.
+            std::vector<unsigned> region;
+            /// Start of each region in position, with one extra entry.
+            std::vector<int> start;
+
+            int numRegions() const { return region.size(); }
+
+            /// Position into the cells of the k'th evaluation.
+            int index(const int k) const { return position.empty() ? k : position[k]; }
+        };
+
+        /// Ordering by PVT region for the given cells. Does not modify
+        /// the object, so it may be called from concurrent evaluations.
+        PvtRegionOrdering regionOrdering(const Cells& cells) const;
+
         RockFromDeck rock_;
 
         // This has to be a shared pointer as we must
@@ -425,6 +486,10 @@ namespace Opm
         std::vector<double> satOilMax_;
         double vap_satmax_guard_;  //Threshold value to promote stability
 
+        // Reuse of PVT evaluations, see setPvtCacheTolerance().
+        double pvt_cache_tolerance_;
+        mutable std::array<PvtPointCache, NumPvtCaches> pvt_cache_;
+
         std::shared_ptr<GasPvt> gasPvt_;
         std::shared_ptr<OilPvt> oilPvt_;
         std::shared_ptr<WaterPvt> waterPvt_;
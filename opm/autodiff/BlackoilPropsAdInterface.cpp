@@ -20,7 +20,36 @@
 #include "config.h"
 
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
+#include <opm/common/ErrorMacros.hpp>
 
 Opm::BlackoilPropsAdInterface::~BlackoilPropsAdInterface()
 {
 }
+
+void Opm::BlackoilPropsAdInterface::bAndMu(const int phase,
+                                           const ADB& p,
+                                           const ADB& T,
+                                           const ADB& rs,
+                                           const ADB& rv,
+                                           const std::vector<PhasePresence>& cond,
+                                           const Cells& cells,
+                                           ADB& b,
+                                           ADB& mu) const
+{
+    switch (phase) {
+    case Water:
+        b = bWat(p, T, cells);
+        mu = muWat(p, T, cells);
+        break;
+    case Oil:
+        b = bOil(p, T, rs, cond, cells);
+        mu = muOil(p, T, rs, cond, cells);
+        break;
+    case Gas:
+        b = bGas(p, T, rv, cond, cells);
+        mu = muGas(p, T, rv, cond, cells);
+        break;
+    default:
+        OPM_THROW(std::runtime_error, "Unknown phase index " << phase);
+    }
+}
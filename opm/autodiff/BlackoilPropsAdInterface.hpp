@@ -174,6 +174,29 @@ namespace Opm
                  const std::vector<PhasePresence>& cond,
                  const Cells& cells) const = 0;
 
+        /// Formation volume factor and viscosity of a phase, evaluated
+        /// together. The default implementation calls the separate
+        /// b and mu functions.
+        /// \param[in]  phase  Phase index (Water, Oil or Gas).
+        /// \param[in]  p      Array of n phase pressure values.
+        /// \param[in]  T      Array of n temperature values.
+        /// \param[in]  rs     Array of n gas solution factor values, used for oil.
+        /// \param[in]  rv     Array of n vapor oil/gas ratios, used for gas.
+        /// \param[in]  cond   Array of n objects, each specifying which phases are present with non-zero saturation in a cell.
+        /// \param[in]  cells  Array of n cell indices to be associated with the pressure values.
+        /// \param[out] b      Array of n formation volume factor values.
+        /// \param[out] mu     Array of n viscosity values.
+        virtual
+        void bAndMu(const int phase,
+                    const ADB& p,
+                    const ADB& T,
+                    const ADB& rs,
+                    const ADB& rv,
+                    const std::vector<PhasePresence>& cond,
+                    const Cells& cells,
+                    ADB& b,
+                    ADB& mu) const;
+
         // ------ Rs bubble point curve ------
 
         /// Bubble point curve for Rs as function of oil pressure.
@@ -179,6 +179,16 @@ namespace Opm {
                          const ADB&              rv   ,
                          const std::vector<PhasePresence>& cond) const;
 
+        void
+        fluidReciprocFVFAndViscosity(const int               phase,
+                                     const ADB&              p    ,
+                                     const ADB&              temp ,
+                                     const ADB&              rs   ,
+                                     const ADB&              rv   ,
+                                     const std::vector<PhasePresence>& cond,
+                                     ADB&                    b    ,
+                                     ADB&                    mu   ) const;
+
         ADB
         fluidDensity(const int  phase,
                      const ADB& b,
@@ -204,6 +214,11 @@ namespace Opm {
         computeAccum(const SolutionState& state,
                      const int            aix  );
 
+        /// The effective properties of miscible solvent depend on
+        /// pressure, so the transport steps use the full assembly.
+        void assembleTransportEq(const ReservoirState& reservoir_state,
+                                 WellState& well_state);
+
         void
         assembleMassBalanceEq(const SolutionState& state);
 
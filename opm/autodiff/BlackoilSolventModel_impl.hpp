@@ -277,6 +277,19 @@ namespace Opm {
 
 
 
+    template <class Grid>
+    void
+    BlackoilSolventModel<Grid>::
+    assembleTransportEq(const ReservoirState& reservoir_state,
+                        WellState& well_state)
+    {
+        assemble(reservoir_state, well_state, false);
+    }
+
+
+
+
+
     template <class Grid>
     void
     BlackoilSolventModel<Grid>::
@@ -343,7 +356,7 @@ namespace Opm {
 
             const std::vector<int> well_cells(wells().well_cells, wells().well_cells + nperf);
             Selector<double> zero_selector(ss.value() + sg.value(), Selector<double>::Zero);
-            ADB F_solvent = subset(zero_selector.select(ss, ss / (ss + sg)),well_cells);
+            ADB F_solvent = wops_.c2p * zero_selector.select(ss, ss / (ss + sg));
 
             const int nw = wells().number_of_wells;
             V injectedSolventFraction = Eigen::Map<const V>(&xw.solventFraction()[0], nperf);
@@ -358,7 +371,7 @@ namespace Opm {
                 }
             }
 
-            const ADB& rs_perfcells = subset(state.rs, well_cells);
+            const ADB& rs_perfcells = wops_.c2p * state.rs;
             int gas_pos = fluid_.phaseUsage().phase_pos[Gas];
             int oil_pos = fluid_.phaseUsage().phase_pos[Oil];
             // remove contribution from the dissolved gas.
@@ -403,7 +416,7 @@ namespace Opm {
         }
 
         // Use cell values for the temperature as the wells don't knows its temperature yet.
-        const ADB perf_temp = subset(state.temperature, well_cells);
+        const ADB perf_temp = wops_.c2p * state.temperature;
 
         // Compute b, rsmax, rvmax values for perforations.
         // Evaluate the properties using average well block pressures
@@ -426,9 +439,9 @@ namespace Opm {
 
         assert(active_[Oil]);
         assert(active_[Gas]);
-        const ADB perf_rv = subset(state.rv, well_cells);
-        const ADB perf_rs = subset(state.rs, well_cells);
-        const V perf_so =  subset(state.saturation[pu.phase_pos[Oil]].value(), well_cells);
+        const ADB perf_rv = wops_.c2p * state.rv;
+        const ADB perf_rs = wops_.c2p * state.rs;
+        const V perf_so =  wops_.c2p * state.saturation[pu.phase_pos[Oil]].value();
         if (pu.phase_used[BlackoilPhases::Liquid]) {
             const V bo = fluid_.bOil(avg_press_ad, perf_temp, perf_rs, perf_cond, well_cells).value();
             //const V bo_eff = subset(rq_[pu.phase_pos[Oil] ].b , well_cells).value();
@@ -465,7 +478,7 @@ namespace Opm {
                                  : zero);
 
                 Selector<double> zero_selector(ss.value() + sg.value(), Selector<double>::Zero);
-                V F_solvent = subset(zero_selector.select(ss, ss / (ss + sg)),well_cells).value();
+                V F_solvent = wops_.c2p * zero_selector.select(ss, ss / (ss + sg)).value();
 
                 V injectedSolventFraction = Eigen::Map<const V>(&xw.solventFraction()[0], nperf);
 
@@ -500,7 +513,7 @@ namespace Opm {
 
         // Extract well connection depths.
         const V depth = cellCentroidsZToEigen(grid_);
-        const V pdepth = subset(depth, well_cells);
+        const V pdepth = wops_.c2p * depth;
         std::vector<double> perf_depth(pdepth.data(), pdepth.data() + nperf);
 
         // Gravity
@@ -680,6 +693,26 @@ namespace Opm {
         }
     }
 
+    template <class Grid>
+    void
+    BlackoilSolventModel<Grid>::fluidReciprocFVFAndViscosity(const int               phase,
+                                                             const ADB&              p    ,
+                                                             const ADB&              temp ,
+                                                             const ADB&              rs   ,
+                                                             const ADB&              rv   ,
+                                                             const std::vector<PhasePresence>& cond,
+                                                             ADB&                    b    ,
+                                                             ADB&                    mu   ) const
+    {
+        if (!is_miscible_) {
+            Base::fluidReciprocFVFAndViscosity(phase, p, temp, rs, rv, cond, b, mu);
+        } else {
+            // The effective properties replace the table values.
+            b = fluidReciprocFVF(phase, p, temp, rs, rv, cond);
+            mu = fluidViscosity(phase, p, temp, rs, rv, cond);
+        }
+    }
+
     template <class Grid>
     ADB
     BlackoilSolventModel<Grid>::fluidDensity(const int  phase,
@@ -1025,13 +1058,12 @@ namespace Opm {
 
         const int nw = wells().number_of_wells;
         const int nperf = wells().well_connpos[nw];
-        const std::vector<int> well_cells(wells().well_cells, wells().well_cells + nperf);
 
         std::vector<ADB> mob_perfcells(np, ADB::null());
         std::vector<ADB> b_perfcells(np, ADB::null());
         for (int phase = 0; phase < np; ++phase) {
-            mob_perfcells[phase] = subset(rq_[phase].mob, well_cells);
-            b_perfcells[phase] = subset(rq_[phase].b, well_cells);
+            mob_perfcells[phase] = wops_.c2p * rq_[phase].mob;
+            b_perfcells[phase] = wops_.c2p * rq_[phase].b;
         }
 
         if (has_solvent_) {
@@ -1041,7 +1073,7 @@ namespace Opm {
             // total gas phase = hydro carbon gas + solvent gas
 
             // The total mobility is the sum of the solvent and gas mobiliy
-            mob_perfcells[gas_pos] += subset(rq_[solvent_pos_].mob, well_cells);
+            mob_perfcells[gas_pos] += wops_.c2p * rq_[solvent_pos_].mob;
 
             // A weighted sum of the b-factors of gas and solvent are used.
             const int nc = Opm::AutoDiffGrid::numCells(grid_);
@@ -1054,11 +1086,11 @@ namespace Opm {
                              : zero);
 
             Selector<double> zero_selector(ss.value() + sg.value(), Selector<double>::Zero);
-            ADB F_solvent = subset(zero_selector.select(ss, ss / (ss + sg)),well_cells);
+            ADB F_solvent = wops_.c2p * zero_selector.select(ss, ss / (ss + sg));
             V ones = V::Constant(nperf,1.0);
 
             b_perfcells[gas_pos] = (ones - F_solvent) * b_perfcells[gas_pos];
-            b_perfcells[gas_pos] += (F_solvent * subset(rq_[solvent_pos_].b, well_cells));
+            b_perfcells[gas_pos] += (F_solvent * (wops_.c2p * rq_[solvent_pos_].b));
 
         }
         if (param_.solve_welleq_initially_ && initial_assembly) {
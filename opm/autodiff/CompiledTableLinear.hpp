@@ -0,0 +1,339 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_COMPILEDTABLELINEAR_HEADER_INCLUDED
+#define OPM_COMPILEDTABLELINEAR_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Piecewise linear table that is resampled once, at construction,
+    /// onto a uniform or logarithmic grid, so that a lookup is a single
+    /// index computation instead of a bisection.
+    ///
+    /// The resampled table is accepted if it reproduces the original
+    /// table to within a tolerance relative to the largest absolute
+    /// table value. Both the original and the resampled table are
+    /// piecewise linear, and they agree at the grid nodes, so the
+    /// largest difference is found at the original breakpoints, where
+    /// it is checked. Grids are tried in order of increasing size, up to
+    /// a maximum number of points. If none of them is accurate enough
+    /// the table keeps the original points and falls back to bisection.
+    ///
+    /// Outside the table range the end intervals of the original table
+    /// are extrapolated linearly, as Opm::linearInterpolation() does.
+    class CompiledTableLinear
+    {
+    public:
+        enum GridSpacing { Uniform = 0, Logarithmic = 1, Automatic = 2 };
+
+        /// Default relative error bound used when compiling a table.
+        static double defaultTolerance()
+        {
+            return 1.0e-6;
+        }
+
+        /// Default largest number of grid points of a compiled table.
+        static int defaultMaxPoints()
+        {
+            return 4096;
+        }
+
+        /// Construct an empty table.
+        CompiledTableLinear()
+            : spacing_(Uniform)
+            , compiled_(false)
+            , x0_(0.0)
+            , inv_h_(0.0)
+            , max_error_(0.0)
+        {
+        }
+
+        /// Construct and compile a table.
+        /// \param[in] x_column    Strictly increasing abscissae.
+        /// \param[in] y_column    Table values, same size as x_column.
+        /// \param[in] tolerance   Error bound, relative to the largest absolute table value.
+        /// \param[in] spacing     Grid spacing to try. Automatic tries both
+        ///                        (logarithmic only if all abscissae are positive)
+        ///                        and keeps the smaller grid.
+        /// \param[in] max_points  Largest number of grid points to try.
+        template <class XContainer, class YContainer>
+        CompiledTableLinear(const XContainer& x_column,
+                            const YContainer& y_column,
+                            const double tolerance = defaultTolerance(),
+                            const GridSpacing spacing = Automatic,
+                            const int max_points = defaultMaxPoints())
+            : spacing_(Uniform)
+            , compiled_(false)
+            , x0_(0.0)
+            , inv_h_(0.0)
+            , max_error_(0.0)
+        {
+            orig_x_.assign(x_column.begin(), x_column.end());
+            orig_y_.assign(y_column.begin(), y_column.end());
+            compile(tolerance, spacing, max_points);
+        }
+
+        /// Table value at x.
+        double operator()(const double x) const
+        {
+            double y, dydx;
+            evaluate(x, y, dydx);
+            return y;
+        }
+
+        /// Derivative of the table at x.
+        double derivative(const double x) const
+        {
+            double y, dydx;
+            evaluate(x, y, dydx);
+            return dydx;
+        }
+
+        /// Table value and derivative at x.
+        void evaluate(const double x, double& y, double& dydx) const
+        {
+            const int n = orig_x_.size();
+            if (n == 1) {
+                y = orig_y_[0];
+                dydx = 0.0;
+                return;
+            }
+            if (x < orig_x_[0] || x > orig_x_[n - 1]) {
+                // Linear extrapolation of the original end intervals.
+                const int i = x < orig_x_[0] ? 0 : n - 2;
+                dydx = (orig_y_[i + 1] - orig_y_[i]) / (orig_x_[i + 1] - orig_x_[i]);
+                y = orig_y_[i] + dydx * (x - orig_x_[i]);
+                return;
+            }
+            if (!compiled_) {
+                const int i = std::min(int(std::upper_bound(orig_x_.begin(), orig_x_.end(), x) - orig_x_.begin()) - 1, n - 2);
+                dydx = (orig_y_[i + 1] - orig_y_[i]) / (orig_x_[i + 1] - orig_x_[i]);
+                y = orig_y_[i] + dydx * (x - orig_x_[i]);
+                return;
+            }
+            const double t = spacing_ == Logarithmic ? std::log(x) : x;
+            const int last = slope_.size() - 1;
+            const int i = std::max(0, std::min(int((t - x0_) * inv_h_), last));
+            dydx = slope_[i];
+            y = y_[i] + dydx * (x - x_[i]);
+        }
+
+        /// \return true if the table was resampled, false if lookups use bisection.
+        bool isCompiled() const
+        {
+            return compiled_;
+        }
+
+        /// \return the spacing of the grid of a compiled table.
+        GridSpacing spacing() const
+        {
+            return spacing_;
+        }
+
+        /// \return the number of grid points of a compiled table, or of
+        ///         the original table if it was not compiled.
+        int numPoints() const
+        {
+            return compiled_ ? x_.size() : orig_x_.size();
+        }
+
+        /// \return the largest absolute difference from the original
+        ///         table, as measured when the table was compiled.
+        double maxError() const
+        {
+            return max_error_;
+        }
+
+        /// \return the abscissae of the original table.
+        const std::vector<double>& xValues() const
+        {
+            return orig_x_;
+        }
+
+        /// \return the values of the original table.
+        const std::vector<double>& yValues() const
+        {
+            return orig_y_;
+        }
+
+    private:
+        struct Grid
+        {
+            std::vector<double> x;
+            std::vector<double> y;
+            std::vector<double> slope;
+            double x0;
+            double inv_h;
+            double max_error;
+        };
+
+        void compile(const double tolerance, const GridSpacing spacing, const int max_points)
+        {
+            const int n = orig_x_.size();
+            if (n == 0 || orig_y_.size() != orig_x_.size()) {
+                OPM_THROW(std::runtime_error, "CompiledTableLinear: table columns must be non-empty and of equal size.");
+            }
+            for (int i = 1; i < n; ++i) {
+                if (!(orig_x_[i] > orig_x_[i - 1])) {
+                    OPM_THROW(std::runtime_error, "CompiledTableLinear: abscissae must be strictly increasing.");
+                }
+            }
+            if (n < 3) {
+                // A single interval is evaluated exactly anyway.
+                return;
+            }
+
+            double y_scale = 0.0;
+            for (int i = 0; i < n; ++i) {
+                y_scale = std::max(y_scale, std::abs(orig_y_[i]));
+            }
+            const double abs_tol = tolerance * y_scale;
+
+            Grid best;
+            bool found = false;
+            if (spacing != Logarithmic) {
+                found = findGrid(Uniform, abs_tol, max_points, best);
+                if (found) {
+                    spacing_ = Uniform;
+                }
+            }
+            if (spacing != Uniform && orig_x_[0] > 0.0) {
+                Grid grid;
+                const int limit = found ? std::min(int(best.x.size()) - 1, max_points) : max_points;
+                if (findGrid(Logarithmic, abs_tol, limit, grid)) {
+                    best = grid;
+                    spacing_ = Logarithmic;
+                    found = true;
+                }
+            }
+            if (found) {
+                x_.swap(best.x);
+                y_.swap(best.y);
+                slope_.swap(best.slope);
+                x0_ = best.x0;
+                inv_h_ = best.inv_h;
+                max_error_ = best.max_error;
+                compiled_ = true;
+            }
+        }
+
+        // Try grids of increasing size until one is within abs_tol of the
+        // original table. Besides doubling the number of intervals, the
+        // multiples of the number of intervals of the finest original
+        // spacing are tried, since those reproduce tables whose
+        // breakpoints lie on a common uniform grid exactly.
+        bool findGrid(const GridSpacing spacing, const double abs_tol,
+                      const int max_points, Grid& grid) const
+        {
+            const int n = orig_x_.size();
+            const double t0 = transform(spacing, orig_x_[0]);
+            const double range = transform(spacing, orig_x_[n - 1]) - t0;
+            double h_min = range;
+            for (int i = 1; i < n; ++i) {
+                h_min = std::min(h_min, transform(spacing, orig_x_[i]) - transform(spacing, orig_x_[i - 1]));
+            }
+            std::vector<int> candidates;
+            for (int m = n - 1; m < max_points; m *= 2) {
+                candidates.push_back(m);
+            }
+            const double m_fine = std::ceil(range / h_min - 1.0e-6);
+            for (int k = 1; k * m_fine < max_points; ++k) {
+                candidates.push_back(k * int(m_fine));
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            for (const int m : candidates) {
+                buildGrid(spacing, t0, range, m, grid);
+                if (grid.max_error <= abs_tol) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void buildGrid(const GridSpacing spacing, const double t0, const double range,
+                       const int num_intervals, Grid& grid) const
+        {
+            const int n = orig_x_.size();
+            const double h = range / num_intervals;
+            grid.x0 = t0;
+            grid.inv_h = 1.0 / h;
+            grid.x.resize(num_intervals + 1);
+            grid.y.resize(num_intervals + 1);
+            grid.slope.resize(num_intervals);
+            int j = 0;
+            for (int k = 0; k <= num_intervals; ++k) {
+                double xk = k == num_intervals ? orig_x_[n - 1] : inverseTransform(spacing, t0 + k * h);
+                xk = std::max(orig_x_[0], std::min(xk, orig_x_[n - 1]));
+                while (j < n - 2 && orig_x_[j + 1] <= xk) {
+                    ++j;
+                }
+                const double s = (orig_y_[j + 1] - orig_y_[j]) / (orig_x_[j + 1] - orig_x_[j]);
+                grid.x[k] = xk;
+                grid.y[k] = orig_y_[j] + s * (xk - orig_x_[j]);
+            }
+            for (int k = 0; k < num_intervals; ++k) {
+                grid.slope[k] = (grid.y[k + 1] - grid.y[k]) / (grid.x[k + 1] - grid.x[k]);
+            }
+
+            // Validate against the original breakpoints, using the same
+            // index computation as evaluate().
+            grid.max_error = 0.0;
+            for (int i = 0; i < n; ++i) {
+                const double t = transform(spacing, orig_x_[i]);
+                const int k = std::max(0, std::min(int((t - t0) * grid.inv_h), num_intervals - 1));
+                const double y = grid.y[k] + grid.slope[k] * (orig_x_[i] - grid.x[k]);
+                grid.max_error = std::max(grid.max_error, std::abs(y - orig_y_[i]));
+            }
+        }
+
+        static double transform(const GridSpacing spacing, const double x)
+        {
+            return spacing == Logarithmic ? std::log(x) : x;
+        }
+
+        static double inverseTransform(const GridSpacing spacing, const double t)
+        {
+            return spacing == Logarithmic ? std::exp(t) : t;
+        }
+
+        std::vector<double> orig_x_;
+        std::vector<double> orig_y_;
+        GridSpacing spacing_;
+        bool compiled_;
+        std::vector<double> x_;
+        std::vector<double> y_;
+        std::vector<double> slope_;
+        double x0_;
+        double inv_h_;
+        double max_error_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_COMPILEDTABLELINEAR_HEADER_INCLUDED
@@ -405,6 +405,7 @@ namespace Opm
 
             // Rock and fluid properties.
             fluidprops_.reset(new BlackoilPropsAdFromDeck(deck_, eclipse_state_, material_law_manager_, grid));
+            fluidprops_->setPvtCacheTolerance(param_.getDefault("pvt_cache_tolerance", -1.0));
 
             // Rock compressibility.
             rock_comp_.reset(new RockCompressibility(deck_, eclipse_state_));
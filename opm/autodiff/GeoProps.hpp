@@ -74,6 +74,7 @@ namespace Opm
             , gpot_ (Vector::Zero(Opm::AutoDiffGrid::cell2Faces(grid).noEntries(), 1))
             , z_(Opm::AutoDiffGrid::numCells(grid))
             , use_local_perm_(use_local_perm)
+            , revision_(0)
         {
             update(grid, props, eclState, grav);
         }
@@ -221,6 +222,8 @@ namespace Opm
                 }
                 std::copy(grav, grav + nd, gravity_);
             }
+
+            ++revision_;
         }
 
         const Vector& poreVolume()       const { return pvol_   ;}
@@ -232,6 +235,11 @@ namespace Opm
         Vector&       transmissibility()       { return trans_  ;}
         const NNC& nnc() const { return nnc_;}
 
+        /// Number of times the properties have been computed by update().
+        /// Users caching quantities derived from the geology compare
+        /// this to the revision they were computed from.
+        int revision() const { return revision_; }
+
     private:
         template <class Grid>
         void multiplyHalfIntersections_(const Grid &grid,
@@ -257,6 +265,7 @@ namespace Opm
         Vector z_;
         double gravity_[3]; // Size 3 even if grid is 2-dim.
         bool use_local_perm_;
+        int revision_;
 
 
         /// Non-neighboring connections
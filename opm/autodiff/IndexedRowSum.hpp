@@ -0,0 +1,267 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_INDEXEDROWSUM_HEADER_INCLUDED
+#define OPM_INDEXEDROWSUM_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiffBlock.hpp>
+
+#include <Eigen/Sparse>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Linear operator whose rows are sums of entries of its argument,
+    ///     y[i] = sum of x[sources[k]] for k in [starts[i], starts[i+1]).
+    ///
+    /// This is a sparse matrix with unit entries, stored as index arrays
+    /// so that gathering (one source per row), scattering and
+    /// accumulation (several sources per row) are done by direct
+    /// indexing instead of sparse matrix products. The rows are
+    /// independent, and are computed in parallel.
+    class IndexedRowSum
+    {
+    public:
+        typedef AutoDiffBlock<double> ADB;
+        typedef ADB::V V;
+        typedef ADB::M M;
+
+        /// Empty operator.
+        IndexedRowSum()
+            : cols_(0)
+            , starts_(1, 0)
+            , target_starts_(1, 0)
+        {
+        }
+
+        /// Construct from index arrays.
+        /// \param[in] cols     size of the argument
+        /// \param[in] starts   start of the sources of each row, followed by sources.size()
+        /// \param[in] sources  entries of the argument summed in each row
+        IndexedRowSum(const int cols, std::vector<int> starts, std::vector<int> sources)
+            : cols_(cols)
+            , starts_(std::move(starts))
+            , sources_(std::move(sources))
+        {
+            assert(!starts_.empty() && starts_.back() == int(sources_.size()));
+            // The rows in which each entry of the argument is summed,
+            // in increasing order.
+            target_starts_.assign(cols_ + 1, 0);
+            for (const int source : sources_) {
+                ++target_starts_[source + 1];
+            }
+            for (int j = 0; j < cols_; ++j) {
+                target_starts_[j + 1] += target_starts_[j];
+            }
+            targets_.resize(sources_.size());
+            std::vector<int> pos(target_starts_.begin(), target_starts_.end() - 1);
+            for (int i = 0; i < rows(); ++i) {
+                for (int k = starts_[i]; k < starts_[i + 1]; ++k) {
+                    targets_[pos[sources_[k]]++] = i;
+                }
+            }
+        }
+
+        /// Operator with y[i] = x[index[i]], or zero if index[i] < 0.
+        static IndexedRowSum gather(const int cols, const std::vector<int>& index)
+        {
+            std::vector<int> starts(1, 0);
+            std::vector<int> sources;
+            starts.reserve(index.size() + 1);
+            sources.reserve(index.size());
+            for (const int source : index) {
+                if (source >= 0) {
+                    sources.push_back(source);
+                }
+                starts.push_back(sources.size());
+            }
+            return IndexedRowSum(cols, std::move(starts), std::move(sources));
+        }
+
+        int rows() const
+        {
+            return starts_.size() - 1;
+        }
+
+        int cols() const
+        {
+            return cols_;
+        }
+
+        /// Apply to a vector of values.
+        V apply(const V& x) const
+        {
+            assert(x.size() == cols_);
+            const int n = rows();
+            V y(n);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < n; ++i) {
+                double sum = 0.0;
+                for (int k = starts_[i]; k < starts_[i + 1]; ++k) {
+                    sum += x[sources_[k]];
+                }
+                y[i] = sum;
+            }
+            return y;
+        }
+
+        /// Apply to the rows of a Jacobian block.
+        ///
+        /// Column j of the result has an entry in each row that sums a
+        /// row with an entry in column j of the block. The columns are
+        /// built directly: identity and diagonal blocks are gathered from
+        /// their diagonals, and sparse blocks are read once in their own
+        /// column-major storage, without conversion or sorting of the
+        /// whole block.
+        M apply(const M& m) const
+        {
+            assert(m.rows() == cols_);
+            const int n = rows();
+            const int ncols = m.cols();
+            if (m.nonZeros() == 0) {
+                return M(n, ncols);
+            }
+
+            std::vector<int> col_start(ncols + 1, 0);
+            std::vector<int> col_size(ncols, 0);
+            std::vector<std::pair<int, double>> entries;
+            if (m.isDiagonal()) {
+                // Entry (j, j) goes to the rows summing entry j, which
+                // are sorted already.
+                for (int j = 0; j < ncols; ++j) {
+                    col_start[j + 1] = col_start[j] + target_starts_[j + 1] - target_starts_[j];
+                }
+                entries.resize(col_start[ncols]);
+#pragma omp parallel for schedule(static)
+                for (int j = 0; j < ncols; ++j) {
+                    const double d = m.coeff(j, j);
+                    if (d == 0.0) {
+                        continue;
+                    }
+                    const auto begin = entries.begin() + col_start[j];
+                    auto end = begin;
+                    for (int k = target_starts_[j]; k < target_starts_[j + 1]; ++k, ++end) {
+                        *end = std::make_pair(targets_[k], d);
+                    }
+                    col_size[j] = mergeSorted(begin, end) - begin;
+                }
+            } else {
+                typedef Eigen::SparseMatrix<double> Sparse;
+                const Sparse& x = m.getSparse();
+#pragma omp parallel for schedule(static)
+                for (int j = 0; j < ncols; ++j) {
+                    int count = 0;
+                    for (Sparse::InnerIterator it(x, j); it; ++it) {
+                        count += target_starts_[it.row() + 1] - target_starts_[it.row()];
+                    }
+                    col_start[j + 1] = count;
+                }
+                for (int j = 0; j < ncols; ++j) {
+                    col_start[j + 1] += col_start[j];
+                }
+                entries.resize(col_start[ncols]);
+#pragma omp parallel for schedule(static)
+                for (int j = 0; j < ncols; ++j) {
+                    const auto begin = entries.begin() + col_start[j];
+                    auto end = begin;
+                    for (Sparse::InnerIterator it(x, j); it; ++it) {
+                        for (int k = target_starts_[it.row()]; k < target_starts_[it.row() + 1]; ++k, ++end) {
+                            *end = std::make_pair(targets_[k], it.value());
+                        }
+                    }
+                    std::sort(begin, end, [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                            return a.first < b.first;
+                        });
+                    col_size[j] = mergeSorted(begin, end) - begin;
+                }
+            }
+
+            Eigen::SparseMatrix<double> y(n, ncols);
+            y.reserve(col_size);
+            for (int j = 0; j < ncols; ++j) {
+                const auto begin = entries.begin() + col_start[j];
+                for (auto it = begin; it != begin + col_size[j]; ++it) {
+                    y.insert(it->first, j) = it->second;
+                }
+            }
+            y.makeCompressed();
+            return M(y);
+        }
+
+        /// Apply to the value and all Jacobian blocks.
+        ADB apply(const ADB& x) const
+        {
+            std::vector<M> jacs;
+            jacs.reserve(x.numBlocks());
+            for (const M& m : x.derivative()) {
+                jacs.push_back(apply(m));
+            }
+            return ADB::function(apply(x.value()), std::move(jacs));
+        }
+
+    private:
+        int cols_;
+        std::vector<int> starts_;
+        std::vector<int> sources_;
+        // Transpose of the index arrays: the rows summing each entry.
+        std::vector<int> target_starts_;
+        std::vector<int> targets_;
+
+        /// Add up the values of entries with the same row, in a range
+        /// sorted by row. Returns the end of the merged range.
+        template <class Iterator>
+        static Iterator mergeSorted(const Iterator begin, const Iterator end)
+        {
+            if (begin == end) {
+                return end;
+            }
+            auto last = begin;
+            for (auto it = begin + 1; it != end; ++it) {
+                if (it->first == last->first) {
+                    last->second += it->second;
+                } else {
+                    *++last = *it;
+                }
+            }
+            return last + 1;
+        }
+    };
+
+
+
+    inline AutoDiffBlock<double> operator*(const IndexedRowSum& op, const AutoDiffBlock<double>& x)
+    {
+        return op.apply(x);
+    }
+
+
+
+    inline AutoDiffBlock<double>::V operator*(const IndexedRowSum& op, const AutoDiffBlock<double>::V& x)
+    {
+        return op.apply(x);
+    }
+
+} // namespace Opm
+
+#endif // OPM_INDEXEDROWSUM_HEADER_INCLUDED
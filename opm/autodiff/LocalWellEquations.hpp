@@ -0,0 +1,302 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LOCALWELLEQUATIONS_HEADER_INCLUDED
+#define OPM_LOCALWELLEQUATIONS_HEADER_INCLUDED
+
+#include <opm/autodiff/AutoDiff.hpp>
+
+#include <Eigen/Dense>
+
+#include <cmath>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The equations of a single standard well, with the reservoir
+    /// quantities at its perforations held fixed.
+    ///
+    /// The unknowns are the surface rates of each active phase followed
+    /// by the bottom hole pressure. The equations are the same as those
+    /// assembled for all wells by BlackoilModelBase::computeWellFlux(),
+    /// addWellFluxEq() and addWellControlEq(): the phase rates minus the
+    /// sum of the connection rates, followed by the control equation.
+    /// Since a well has only a few unknowns its Jacobian is dense, and
+    /// is computed by forward differentiation one column at a time.
+    class LocalWellEquations
+    {
+    public:
+        typedef Eigen::VectorXd Vector;
+        typedef Eigen::MatrixXd Matrix;
+
+        /// The control equations supported.
+        enum ControlType { Bhp, Rate };
+
+        /// Set up an empty well.
+        /// \param[in] num_phases  number of active phases
+        /// \param[in] oil_pos     position of oil among the active phases, -1 if inactive
+        /// \param[in] gas_pos     position of gas among the active phases, -1 if inactive
+        /// \param[in] injector    true for an injector, false for a producer
+        /// \param[in] allow_cf    true if cross flow is allowed
+        /// \param[in] comp_frac   injected composition, one entry per active phase
+        LocalWellEquations(const int num_phases,
+                           const int oil_pos,
+                           const int gas_pos,
+                           const bool injector,
+                           const bool allow_cf,
+                           const std::vector<double>& comp_frac)
+            : np_(num_phases)
+            , oil_pos_(oil_pos)
+            , gas_pos_(gas_pos)
+            , injector_(injector)
+            , allow_cf_(allow_cf)
+            , comp_frac_(comp_frac)
+            , control_(Bhp)
+            , target_(0.0)
+            , distr_(num_phases, 0.0)
+        {
+        }
+
+        /// Add a perforation.
+        /// \param[in] well_index     connection transmissibility factor
+        /// \param[in] cell_pressure  pressure of the perforated cell
+        /// \param[in] pressure_diff  perforation pressure minus bottom hole pressure
+        /// \param[in] rs             dissolved gas-oil ratio of the cell
+        /// \param[in] rv             vaporized oil-gas ratio of the cell
+        /// \param[in] mob            phase mobilities of the cell, one per active phase
+        /// \param[in] b              reciprocal formation volume factors, one per active phase
+        void addPerforation(const double well_index,
+                            const double cell_pressure,
+                            const double pressure_diff,
+                            const double rs,
+                            const double rv,
+                            const double* mob,
+                            const double* b)
+        {
+            well_index_.push_back(well_index);
+            cell_pressure_.push_back(cell_pressure);
+            pressure_diff_.push_back(pressure_diff);
+            rs_.push_back(rs);
+            rv_.push_back(rv);
+            mob_.insert(mob_.end(), mob, mob + np_);
+            b_.insert(b_.end(), b, b + np_);
+        }
+
+        /// Set the control equation.
+        /// \param[in] control  control type
+        /// \param[in] target   target bottom hole pressure or rate
+        /// \param[in] distr    rate distribution, one entry per active phase,
+        ///                     only used for rate controls
+        void setControl(const ControlType control, const double target, const double* distr)
+        {
+            control_ = control;
+            target_ = target;
+            if (control == Rate) {
+                distr_.assign(distr, distr + np_);
+            }
+        }
+
+        /// \return the number of unknowns and equations, i.e. the
+        ///         number of active phases plus one.
+        int size() const
+        {
+            return np_ + 1;
+        }
+
+        /// \return the number of perforations.
+        int numPerforations() const
+        {
+            return well_index_.size();
+        }
+
+        /// Residual and Jacobian of the well equations.
+        /// \param[in]  x           unknowns, phase rates followed by bhp
+        /// \param[out] residual    residual, size() entries
+        /// \param[out] jacobian    derivatives of residual with respect to x
+        /// \param[out] perf_rates  connection rates at surface conditions,
+        ///                         numPerforations() times num_phases entries,
+        ///                         perforation-major
+        void linearise(const Vector& x, Vector& residual, Matrix& jacobian,
+                       std::vector<double>& perf_rates) const
+        {
+            const int n = size();
+            residual.resize(n);
+            jacobian.resize(n, n);
+            std::vector<Eval> xe(n, Eval::constant(0.0));
+            std::vector<Eval> res;
+            std::vector<Eval> cq_s;
+            for (int col = 0; col < n; ++col) {
+                for (int i = 0; i < n; ++i) {
+                    xe[i] = i == col ? Eval::variable(x[i]) : Eval::constant(x[i]);
+                }
+                evaluate(xe, res, cq_s);
+                for (int i = 0; i < n; ++i) {
+                    jacobian(i, col) = res[i].der();
+                }
+            }
+            for (int i = 0; i < n; ++i) {
+                residual[i] = res[i].val();
+            }
+            perf_rates.resize(cq_s.size());
+            for (std::size_t i = 0; i < cq_s.size(); ++i) {
+                perf_rates[i] = cq_s[i].val();
+            }
+        }
+
+    private:
+        typedef AutoDiff<double> Eval;
+
+        void evaluate(const std::vector<Eval>& x, std::vector<Eval>& res, std::vector<Eval>& cq_s) const
+        {
+            const int nperf = numPerforations();
+            const Eval& bhp = x[np_];
+
+            // Pressure drawdown, selecting injecting and producing perforations.
+            std::vector<Eval> drawdown;
+            drawdown.reserve(nperf);
+            std::vector<double> injecting(nperf, 0.0);
+            std::vector<double> producing(nperf, 0.0);
+            int num_injecting = 0;
+            int num_producing = 0;
+            for (int perf = 0; perf < nperf; ++perf) {
+                drawdown.push_back(cell_pressure_[perf] - (bhp + pressure_diff_[perf]));
+                if (drawdown[perf].val() < 0) {
+                    injecting[perf] = 1.0;
+                    ++num_injecting;
+                } else {
+                    producing[perf] = 1.0;
+                    ++num_producing;
+                }
+            }
+            if (!allow_cf_) {
+                for (int perf = 0; perf < nperf; ++perf) {
+                    if (injector_ && num_injecting > 0) {
+                        producing[perf] = 0.0;
+                    } else if (!injector_ && num_producing > 0) {
+                        injecting[perf] = 0.0;
+                    }
+                }
+            }
+
+            // Flow into the wellbore, and the total flow out of it.
+            std::vector<Eval> cq_ps(nperf * np_, Eval::constant(0.0));
+            std::vector<Eval> cqt_i(nperf, Eval::constant(0.0));
+            for (int perf = 0; perf < nperf; ++perf) {
+                double total_mob = 0.0;
+                for (int phase = 0; phase < np_; ++phase) {
+                    const double mob = mob_[perf*np_ + phase];
+                    cq_ps[perf*np_ + phase] = (-producing[perf] * well_index_[perf] * mob * b_[perf*np_ + phase]) * drawdown[perf];
+                    total_mob += mob;
+                }
+                if (oil_pos_ >= 0 && gas_pos_ >= 0) {
+                    const Eval oil = cq_ps[perf*np_ + oil_pos_];
+                    const Eval gas = cq_ps[perf*np_ + gas_pos_];
+                    cq_ps[perf*np_ + gas_pos_] += rs_[perf] * oil;
+                    cq_ps[perf*np_ + oil_pos_] += rv_[perf] * gas;
+                }
+                cqt_i[perf] = (-injecting[perf] * well_index_[perf] * total_mob) * drawdown[perf];
+            }
+
+            // Wellbore mixture at standard conditions.
+            std::vector<Eval> wbq(np_, Eval::constant(0.0));
+            Eval wbqt = Eval::constant(0.0);
+            for (int phase = 0; phase < np_; ++phase) {
+                if (x[phase].val() > 0.0) {
+                    wbq[phase] = comp_frac_[phase] * x[phase];
+                }
+                for (int perf = 0; perf < nperf; ++perf) {
+                    wbq[phase] -= cq_ps[perf*np_ + phase];
+                }
+                wbqt += wbq[phase];
+            }
+            const bool alive = wbqt.val() != 0.0;
+            std::vector<Eval> cmix_s(np_, Eval::constant(0.0));
+            for (int phase = 0; phase < np_; ++phase) {
+                cmix_s[phase] = alive ? wbq[phase] / wbqt : Eval::constant(comp_frac_[phase]);
+            }
+
+            // Connection rates at standard conditions.
+            cq_s.assign(nperf * np_, Eval::constant(0.0));
+            for (int perf = 0; perf < nperf; ++perf) {
+                const double d = 1.0 - rv_[perf] * rs_[perf];
+                Eval volume_ratio = Eval::constant(0.0);
+                for (int phase = 0; phase < np_; ++phase) {
+                    Eval tmp = cmix_s[phase];
+                    if (phase == oil_pos_ && gas_pos_ >= 0) {
+                        tmp -= rv_[perf] * cmix_s[gas_pos_] / d;
+                    }
+                    if (phase == gas_pos_ && oil_pos_ >= 0) {
+                        tmp -= rs_[perf] * cmix_s[oil_pos_] / d;
+                    }
+                    volume_ratio += tmp / b_[perf*np_ + phase];
+                }
+                const Eval cqt_is = cqt_i[perf] / volume_ratio;
+                for (int phase = 0; phase < np_; ++phase) {
+                    cq_s[perf*np_ + phase] = cq_ps[perf*np_ + phase] + cmix_s[phase] * cqt_is;
+                }
+            }
+
+            // Rate equations.
+            res.assign(np_ + 1, Eval::constant(0.0));
+            for (int phase = 0; phase < np_; ++phase) {
+                res[phase] = x[phase];
+                for (int perf = 0; perf < nperf; ++perf) {
+                    res[phase] -= cq_s[perf*np_ + phase];
+                }
+            }
+
+            // Control equation. A dead well is required to have zero
+            // total rate.
+            Eval& control = res[np_];
+            if (!alive) {
+                for (int phase = 0; phase < np_; ++phase) {
+                    control += x[phase];
+                }
+            } else if (control_ == Bhp) {
+                control = bhp - target_;
+            } else {
+                for (int phase = 0; phase < np_; ++phase) {
+                    control += distr_[phase] * x[phase];
+                }
+                control -= target_;
+            }
+        }
+
+        int np_;
+        int oil_pos_;
+        int gas_pos_;
+        bool injector_;
+        bool allow_cf_;
+        std::vector<double> comp_frac_;
+        std::vector<double> well_index_;
+        std::vector<double> cell_pressure_;
+        std::vector<double> pressure_diff_;
+        std::vector<double> rs_;
+        std::vector<double> rv_;
+        std::vector<double> mob_;
+        std::vector<double> b_;
+        ControlType control_;
+        double target_;
+        std::vector<double> distr_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_LOCALWELLEQUATIONS_HEADER_INCLUDED
@@ -23,6 +23,7 @@
 #include <opm/autodiff/NewtonIterationUtilities.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
 
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #if HAVE_UMFPACK
@@ -30,8 +31,14 @@
 #else
 #include <Eigen/SparseLU>
 #endif
+#include <Eigen/Dense>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
 namespace Opm
 {
 
@@ -288,5 +295,175 @@ namespace Opm
 
 
 
+
+
+
+    V solveReorderedSystem(const Eigen::SparseMatrix<double, Eigen::RowMajor>& A,
+                           const V& b,
+                           const int num_cells)
+    {
+        typedef Eigen::SparseMatrix<double, Eigen::RowMajor> RowMat;
+        const int n = A.rows();
+        if (A.cols() != n || b.size() != n || num_cells <= 0 || n % num_cells != 0) {
+            OPM_THROW(std::logic_error, "solveReorderedSystem() requires a square system "
+                      "with the same number of unknowns in every cell.");
+        }
+        const int num_vars = n / num_cells;
+
+        // Build the cell dependency graph.
+        std::vector<std::vector<int>> deps(num_cells);
+        {
+            std::vector<int> last_seen(num_cells, -1);
+            for (int row = 0; row < n; ++row) {
+                const int cell = row % num_cells;
+                for (RowMat::InnerIterator it(A, row); it; ++it) {
+                    const int other = it.col() % num_cells;
+                    if (other != cell && last_seen[other] != cell && it.value() != 0.0) {
+                        last_seen[other] = cell;
+                        deps[cell].push_back(other);
+                    }
+                }
+            }
+        }
+
+        // Tarjan's algorithm, without recursion. A component is completed
+        // only after all components it depends on, so the components are
+        // found in an order in which they can be solved.
+        std::vector<int> comp_cells;
+        comp_cells.reserve(num_cells);
+        std::vector<int> comp_start(1, 0);
+        {
+            std::vector<int> index(num_cells, -1);
+            std::vector<int> lowlink(num_cells, 0);
+            std::vector<char> on_stack(num_cells, 0);
+            std::vector<int> stack;
+            std::vector<std::pair<int, int>> call_stack;
+            int counter = 0;
+            for (int root = 0; root < num_cells; ++root) {
+                if (index[root] >= 0) {
+                    continue;
+                }
+                index[root] = lowlink[root] = counter++;
+                stack.push_back(root);
+                on_stack[root] = 1;
+                call_stack.emplace_back(root, 0);
+                while (!call_stack.empty()) {
+                    const int cell = call_stack.back().first;
+                    const int pos = call_stack.back().second;
+                    if (pos < int(deps[cell].size())) {
+                        ++call_stack.back().second;
+                        const int other = deps[cell][pos];
+                        if (index[other] < 0) {
+                            index[other] = lowlink[other] = counter++;
+                            stack.push_back(other);
+                            on_stack[other] = 1;
+                            call_stack.emplace_back(other, 0);
+                        } else if (on_stack[other]) {
+                            lowlink[cell] = std::min(lowlink[cell], index[other]);
+                        }
+                    } else {
+                        if (lowlink[cell] == index[cell]) {
+                            int other;
+                            do {
+                                other = stack.back();
+                                stack.pop_back();
+                                on_stack[other] = 0;
+                                comp_cells.push_back(other);
+                            } while (other != cell);
+                            comp_start.push_back(comp_cells.size());
+                        }
+                        call_stack.pop_back();
+                        if (!call_stack.empty()) {
+                            const int parent = call_stack.back().first;
+                            lowlink[parent] = std::min(lowlink[parent], lowlink[cell]);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Solve the components in order. Small components are solved
+        // densely, large ones (e.g. counter-current flow regions) with
+        // a sparse direct solver.
+        const int max_dense_size = 64;
+        V x = V::Zero(n);
+        std::vector<int> local(num_cells, -1);
+        const int num_comp = comp_start.size() - 1;
+        for (int comp = 0; comp < num_comp; ++comp) {
+            const int* cells = comp_cells.data() + comp_start[comp];
+            const int m = comp_start[comp + 1] - comp_start[comp];
+            for (int i = 0; i < m; ++i) {
+                local[cells[i]] = i;
+            }
+            const int size = m * num_vars;
+            Eigen::VectorXd rhs(size);
+            std::vector< Eigen::Triplet<double> > t;
+            for (int eq = 0; eq < num_vars; ++eq) {
+                for (int i = 0; i < m; ++i) {
+                    const int row = eq*num_cells + cells[i];
+                    const int lrow = eq*m + i;
+                    rhs[lrow] = b[row];
+                    for (RowMat::InnerIterator it(A, row); it; ++it) {
+                        const int col = it.col();
+                        const int lcell = local[col % num_cells];
+                        if (lcell >= 0) {
+                            t.emplace_back(lrow, (col / num_cells)*m + lcell, it.value());
+                        } else {
+                            rhs[lrow] -= it.value() * x[col];
+                        }
+                    }
+                }
+            }
+            Eigen::VectorXd sol;
+            if (size <= max_dense_size) {
+                Eigen::MatrixXd Mloc = Eigen::MatrixXd::Zero(size, size);
+                for (const auto& tri : t) {
+                    Mloc(tri.row(), tri.col()) += tri.value();
+                }
+                const Eigen::PartialPivLU<Eigen::MatrixXd> lu(Mloc);
+                // Partial pivoting does not report singular matrices,
+                // they show up as zero pivots.
+                if ((lu.matrixLU().diagonal().array() == 0.0).any()) {
+                    OPM_THROW(LinearSolverProblem, "solveReorderedSystem(): singular block of "
+                              << m << " cells.");
+                }
+                sol = lu.solve(rhs);
+            } else {
+                S Mloc(size, size);
+                Mloc.setFromTriplets(t.begin(), t.end());
+#if HAVE_UMFPACK
+                Eigen::UmfPackLU<S> solver(Mloc);
+#else
+                Eigen::SparseLU<S> solver(Mloc);
+#endif
+                if (solver.info() != Eigen::Success) {
+                    OPM_THROW(LinearSolverProblem, "solveReorderedSystem(): factorisation of a block of "
+                              << m << " cells failed.");
+                }
+                sol = solver.solve(rhs);
+                if (solver.info() != Eigen::Success) {
+                    OPM_THROW(LinearSolverProblem, "solveReorderedSystem(): solve of a block of "
+                              << m << " cells failed.");
+                }
+            }
+            for (int i = 0; i < size; ++i) {
+                if (!std::isfinite(sol[i])) {
+                    OPM_THROW(LinearSolverProblem, "solveReorderedSystem(): non-finite solution in a block of "
+                              << m << " cells.");
+                }
+            }
+            for (int var = 0; var < num_vars; ++var) {
+                for (int i = 0; i < m; ++i) {
+                    x[var*num_cells + cells[i]] = sol[var*m + i];
+                }
+            }
+            for (int i = 0; i < m; ++i) {
+                local[cells[i]] = -1;
+            }
+        }
+        return x;
+    }
+
+
 } // namespace Opm
 
@@ -58,6 +58,24 @@ namespace Opm
                             Eigen::SparseMatrix<double, Eigen::RowMajor>& A,
                             AutoDiffBlock<double>::V& b);
 
+    /// Solve a linear system by block substitution along its cell graph.
+    /// Cell c depends on cell d if an equation of c has a nonzero
+    /// coefficient for an unknown of d. The strongly connected
+    /// components of this graph are solved one at a time, each after
+    /// all components it depends on. This is efficient for systems
+    /// that are close to triangular, such as linearised transport
+    /// equations with upwind fluxes at fixed pressure.
+    /// \param[in]  A          square system matrix
+    /// \param[in]  b          right hand side
+    /// \param[in]  num_cells  number of cells, unknowns and equations are
+    ///                        ordered as var*num_cells + cell
+    /// \return                the solution x of Ax = b
+    /// Throws LinearSolverProblem if a component cannot be solved.
+    AutoDiffBlock<double>::V
+    solveReorderedSystem(const Eigen::SparseMatrix<double, Eigen::RowMajor>& A,
+                         const AutoDiffBlock<double>::V& b,
+                         const int num_cells);
+
 
 } // namespace Opm
 
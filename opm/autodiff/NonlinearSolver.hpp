@@ -76,10 +76,14 @@ namespace Opm {
 
         /// Take a single forward step, after which the states will be modified
         /// according to the physical model.
+        /// If the step fails, the caller must restore the states before
+        /// retrying with a shorter step; the model may then reuse quantities
+        /// it computed from the start-of-step state in the failed attempt.
         /// \param[in] dt                time step size
         /// \param[in] reservoir_state   reservoir state variables
         /// \param[in] well_state        well state variables
-        /// \return                      number of linear iterations used
+        /// \return                      number of linear iterations used,
+        ///                              or -1 if the step failed to converge
         int
         step(const double dt,
              ReservoirState& reservoir_state,
@@ -0,0 +1,141 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PVTPOINTCACHE_HEADER_INCLUDED
+#define OPM_PVTPOINTCACHE_HEADER_INCLUDED
+
+#include <cmath>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Cell-wise cache of a single PVT quantity f(p, T, r) and its
+    /// derivatives with respect to pressure and rs/rv.
+    ///
+    /// Every cell stores the point at which the quantity was last
+    /// evaluated. A lookup is a hit if pressure, temperature and r
+    /// have all moved by less than a relative tolerance from that
+    /// point, and if the saturation branch (saturated or undersaturated
+    /// table) is unchanged. On a hit the value is extrapolated to first
+    /// order from the stored point, while the stored derivatives are
+    /// reused as they are. The stored point is only moved by store(),
+    /// so the cached value cannot drift through repeated hits.
+    class PvtPointCache
+    {
+    public:
+        /// Construct an empty cache.
+        PvtPointCache()
+        {
+        }
+
+        /// Remove all cached entries, and size the cache for num_cells cells.
+        void reset(const int num_cells)
+        {
+            valid_.assign(num_cells, 0);
+            p_.resize(num_cells);
+            T_.resize(num_cells);
+            r_.resize(num_cells);
+            saturated_.resize(num_cells);
+            value_.resize(num_cells);
+            dp_.resize(num_cells);
+            dr_.resize(num_cells);
+        }
+
+        /// \return the number of cells the cache is sized for.
+        int size() const
+        {
+            return valid_.size();
+        }
+
+        /// Look up the quantity in a cell.
+        /// \param[in]  cell       Cell index.
+        /// \param[in]  p          Pressure.
+        /// \param[in]  T          Temperature.
+        /// \param[in]  r          Dissolution factor (rs or rv), ignored if saturated.
+        /// \param[in]  saturated  True if the saturated table is to be used.
+        /// \param[in]  tol        Relative tolerance on p, T and r.
+        /// \param[out] value      Quantity extrapolated to (p, r), set on a hit only.
+        /// \param[out] dp         Derivative with respect to p, set on a hit only.
+        /// \param[out] dr         Derivative with respect to r, set on a hit only.
+        /// \return true if the cached entry was used.
+        bool lookup(const int cell,
+                    const double p,
+                    const double T,
+                    const double r,
+                    const bool saturated,
+                    const double tol,
+                    double& value,
+                    double& dp,
+                    double& dr) const
+        {
+            if (!valid_[cell] || bool(saturated_[cell]) != saturated) {
+                return false;
+            }
+            const double delta_p = p - p_[cell];
+            if (std::abs(delta_p) > tol*std::abs(p_[cell])) {
+                return false;
+            }
+            if (std::abs(T - T_[cell]) > tol*std::abs(T_[cell])) {
+                return false;
+            }
+            const double delta_r = saturated ? 0.0 : r - r_[cell];
+            if (std::abs(delta_r) > tol*std::abs(r_[cell])) {
+                return false;
+            }
+            value = value_[cell] + dp_[cell]*delta_p + dr_[cell]*delta_r;
+            dp = dp_[cell];
+            dr = dr_[cell];
+            return true;
+        }
+
+        /// Store a freshly evaluated quantity in a cell.
+        void store(const int cell,
+                   const double p,
+                   const double T,
+                   const double r,
+                   const bool saturated,
+                   const double value,
+                   const double dp,
+                   const double dr)
+        {
+            valid_[cell] = 1;
+            p_[cell] = p;
+            T_[cell] = T;
+            r_[cell] = saturated ? 0.0 : r;
+            saturated_[cell] = saturated;
+            value_[cell] = value;
+            dp_[cell] = dp;
+            dr_[cell] = dr;
+        }
+
+    private:
+        std::vector<char> valid_;
+        std::vector<double> p_;
+        std::vector<double> T_;
+        std::vector<double> r_;
+        std::vector<char> saturated_;
+        std::vector<double> value_;
+        std::vector<double> dp_;
+        std::vector<double> dr_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PVTPOINTCACHE_HEADER_INCLUDED
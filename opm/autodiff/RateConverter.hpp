@@ -32,8 +32,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -414,6 +416,13 @@ namespace Opm {
                 , attr_ (rmap_, Attributes(props_.numPhases()))
             {}
 
+            /**
+             * Region identifier.
+             *
+             * Integral type.
+             */
+            typedef typename RegionMapping<Region>::RegionId RegionId;
+
             /**
              * Compute average hydrocarbon pressure and maximum
              * dissolution and evaporation at average hydrocarbon
@@ -433,28 +442,46 @@ namespace Opm {
             defineState(const BlackoilState& state,
                         const boost::any& info = boost::any())
             {
+                const auto& active = rmap_.activeRegions();
+                const std::vector<RegionId> regions(active.begin(), active.end());
+                defineState(state, info, regions);
+            }
+
+            /**
+             * Compute average hydrocarbon pressure and maximum
+             * dissolution and evaporation at average hydrocarbon
+             * pressure in a subset of the regions.
+             *
+             * The attributes of the other regions are left as they
+             * are.  In a parallel run all processes must pass the same
+             * regions.
+             *
+             * \param[in] state   Dynamic reservoir state.
+             * \param[in] info    The information and communication utilities
+             *                    about/of the parallelization, as above.
+             * \param[in] regions Regions to update.
+             */
+            void
+            defineState(const BlackoilState& state,
+                        const boost::any& info,
+                        const std::vector<RegionId>& regions)
+            {
 #if HAVE_MPI
                 if( info.type() == typeid(ParallelISTLInformation) )
                 {
                     const auto& ownership =
                         boost::any_cast<const ParallelISTLInformation&>(info)
                         .updateOwnerMask(state.pressure());
-                    calcAverages<true>(state, info, ownership);
+                    calcAverages<true>(state, info, ownership, regions);
                 }
                 else
 #endif
                 {
                     std::vector<double> dummyOwnership; // not actually used
-                    calcAverages<false>(state, info, dummyOwnership);
-                }   
-                calcRmax();
+                    calcAverages<false>(state, info, dummyOwnership, regions);
+                }
+                calcRmax(regions);
             }
-            /**
-             * Region identifier.
-             *
-             * Integral type.
-             */
-            typedef typename RegionMapping<Region>::RegionId RegionId;
 
             /**
              * Compute coefficients for surface-to-reservoir voidage
@@ -611,8 +638,11 @@ namespace Opm {
             };
 
             /**
-             * Compute average hydrocarbon pressure and temperatures in all
-             * regions.
+             * Compute average hydrocarbon pressure and temperatures in a
+             * set of regions.
+             *
+             * The cells of each region are summed by all threads, and the
+             * sums of all regions are reduced across processes at once.
              *
              * \param[in] state       Dynamic reservoir state.
              * \param[in] info        The information and communication utilities
@@ -620,6 +650,7 @@ namespace Opm {
              * \param[in] ownership   In a parallel run this is vector containing
              *                        1 for every owned unknown, zero otherwise.
              *                        Not used in a sequential run.
+             * \param[in] regions     Regions to compute the averages for.
              * \tparam    is_parallel True if the run is parallel. In this case
              *                        info has to contain a ParallelISTLInformation
              *                        object.
@@ -627,52 +658,61 @@ namespace Opm {
             template<bool is_parallel>
             void
             calcAverages(const BlackoilState& state, const boost::any& info,
-                         const std::vector<double>& ownerShip)
+                         const std::vector<double>& ownerShip,
+                         const std::vector<RegionId>& regions)
             {
                 const auto& press = state.pressure();
                 const auto& temp  = state.temperature();
 
-                for (const auto& reg : rmap_.activeRegions()) {
-                    auto& ra = attr_.attributes(reg);
-                    auto& p  = ra.pressure;
-                    auto& T  = ra.temperature;
-
-                    std::size_t n = 0;
-                    p = T = 0.0;
-                    for (const auto& cell : rmap_.cells(reg)) {
+                // Sum of pressures, sum of temperatures and number of
+                // cells for each region.
+                const std::size_t nreg = regions.size();
+                std::vector<double> sums(3 * nreg, 0.0);
+                for (std::size_t r = 0; r < nreg; ++r) {
+                    const auto& cells = rmap_.cells(regions[r]);
+                    const auto first = cells.begin();
+                    const int ncells = std::distance(first, cells.end());
+                    double p = 0.0;
+                    double T = 0.0;
+                    double n = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:p,T,n)
+                    for (int i = 0; i < ncells; ++i) {
                         auto increment = Details::
                             AverageIncrementCalculator<is_parallel>()(press, temp,
                                                                       ownerShip,
-                                                                      cell);
+                                                                      first[i]);
                         p += std::get<0>(increment);
                         T += std::get<1>(increment);
                         n += std::get<2>(increment);
                     }
-                    std::size_t global_n = n;
-                    double global_p = p;
-                    double global_T = T;
+                    sums[3*r + 0] = p;
+                    sums[3*r + 1] = T;
+                    sums[3*r + 2] = n;
+                }
 #if HAVE_MPI
-                    if ( is_parallel )
-                    {
-                        const auto& real_info = boost::any_cast<const ParallelISTLInformation&>(info);
-                        global_n = real_info.communicator().sum(n);
-                        global_p = real_info.communicator().sum(p);
-                        global_T = real_info.communicator().sum(T);
-                    }
+                if ( is_parallel && nreg > 0 )
+                {
+                    const auto& real_info = boost::any_cast<const ParallelISTLInformation&>(info);
+                    real_info.communicator().sum(sums.data(), sums.size());
+                }
+#else
+                static_cast<void>(info);
 #endif
-                    p = global_p / global_n;
-                    T = global_T / global_n;
+                for (std::size_t r = 0; r < nreg; ++r) {
+                    auto& ra = attr_.attributes(regions[r]);
+                    ra.pressure    = sums[3*r + 0] / sums[3*r + 2];
+                    ra.temperature = sums[3*r + 1] / sums[3*r + 2];
                 }
             }
             /**
              * Compute maximum dissolution and evaporation ratios at
-             * average hydrocarbon pressure.
+             * average hydrocarbon pressure in a set of regions.
              *
-             * Uses the pressure value computed by averagePressure()
+             * Uses the pressure value computed by calcAverages()
              * and must therefore be called *after* that method.
              */
             void
-            calcRmax()
+            calcRmax(const std::vector<RegionId>& regions)
             {
                 const PhaseUsage& pu = props_.phaseUsage();
 
@@ -688,7 +728,7 @@ namespace Opm {
                     // average *hydrocarbon* pressure rather than
                     // average phase pressure.
 
-                    for (const auto& reg : rmap_.activeRegions()) {
+                    for (const auto& reg : regions) {
                         auto& ra = attr_.attributes(reg);
 
                         const auto c = this->getRegCell(reg);
@@ -0,0 +1,185 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+#define OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <Eigen/Dense>
+
+#include <vector>
+
+namespace Opm
+{
+
+    /// Direct solver for linear systems with the structure of the
+    /// equations of multi-segment wells.
+    ///
+    /// The segments of a well form a tree, with the top segment as the
+    /// root, and the equations of a segment only involve the unknowns
+    /// of the segment itself, of its outlet segment and of its inlet
+    /// segments. With one dense block of unknowns per segment, the
+    /// system can be solved by block Gaussian elimination from the
+    /// leaves to the root, followed by back substitution from the root,
+    /// without any fill-in. The cost is linear in the number of
+    /// segments. Several wells may be solved together, as a forest.
+    ///
+    /// The unknowns and equations are ordered segment by segment, with
+    /// blockSize() entries for each segment.
+    class SegmentTreeSolver
+    {
+    public:
+        typedef Eigen::MatrixXd Block;
+
+        /// Set up the solver for a set of segment trees.
+        /// \param[in] outlet      outlet segment of each segment, -1 for the top segments
+        /// \param[in] block_size  number of unknowns and equations per segment
+        SegmentTreeSolver(const std::vector<int>& outlet, const int block_size)
+            : outlet_(outlet)
+            , block_size_(block_size)
+            , diagonal_(outlet.size(), Block::Zero(block_size, block_size))
+            , to_outlet_(outlet.size(), Block::Zero(block_size, block_size))
+            , from_outlet_(outlet.size(), Block::Zero(block_size, block_size))
+            , lu_(outlet.size())
+            , eliminated_(outlet.size())
+        {
+            // Order the segments from the roots, each segment after its outlet.
+            const int nseg = outlet.size();
+            std::vector<std::vector<int>> inlets(nseg);
+            order_.reserve(nseg);
+            for (int seg = 0; seg < nseg; ++seg) {
+                if (outlet[seg] < 0) {
+                    order_.push_back(seg);
+                } else if (outlet[seg] < nseg) {
+                    inlets[outlet[seg]].push_back(seg);
+                } else {
+                    OPM_THROW(std::logic_error, "Outlet of segment " << seg << " out of range.");
+                }
+            }
+            for (std::size_t i = 0; i < order_.size(); ++i) {
+                const std::vector<int>& seg_inlets = inlets[order_[i]];
+                order_.insert(order_.end(), seg_inlets.begin(), seg_inlets.end());
+            }
+            if (int(order_.size()) != nseg) {
+                OPM_THROW(std::logic_error, "The segments do not form a set of trees.");
+            }
+        }
+
+        /// \return the number of segments.
+        int numSegments() const
+        {
+            return outlet_.size();
+        }
+
+        /// \return the number of unknowns and equations per segment.
+        int blockSize() const
+        {
+            return block_size_;
+        }
+
+        /// Set all blocks to zero.
+        void setZero()
+        {
+            for (int seg = 0; seg < numSegments(); ++seg) {
+                diagonal_[seg].setZero();
+                to_outlet_[seg].setZero();
+                from_outlet_[seg].setZero();
+            }
+        }
+
+        /// Derivatives of the equations of a segment with respect to
+        /// its own unknowns.
+        Block& diagonal(const int seg)
+        {
+            return diagonal_[seg];
+        }
+
+        /// Derivatives of the equations of a segment with respect to
+        /// the unknowns of its outlet segment.
+        Block& toOutlet(const int seg)
+        {
+            return to_outlet_[seg];
+        }
+
+        /// Derivatives of the equations of the outlet segment of a
+        /// segment with respect to the unknowns of the segment.
+        Block& fromOutlet(const int seg)
+        {
+            return from_outlet_[seg];
+        }
+
+        /// Eliminate the segments from the leaves to the roots. Must be
+        /// called after the blocks are set, and before solve().
+        void factorize()
+        {
+            std::vector<Block> schur = diagonal_;
+            for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+                const int seg = *it;
+                lu_[seg].compute(schur[seg]);
+                const int out = outlet_[seg];
+                if (out >= 0) {
+                    eliminated_[seg] = lu_[seg].solve(to_outlet_[seg]);
+                    schur[out].noalias() -= from_outlet_[seg] * eliminated_[seg];
+                }
+            }
+        }
+
+        /// Solve the system for one or more right hand sides.
+        /// \param[in, out] x  right hand sides on input, solutions on output,
+        ///                    numSegments() times blockSize() rows
+        template <class Derived>
+        void solve(Eigen::MatrixBase<Derived>& x) const
+        {
+            const int bs = block_size_;
+            // Forward elimination, from the leaves.
+            for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+                const int seg = *it;
+                x.middleRows(seg*bs, bs) = lu_[seg].solve(x.middleRows(seg*bs, bs));
+                const int out = outlet_[seg];
+                if (out >= 0) {
+                    x.middleRows(out*bs, bs) -= from_outlet_[seg] * x.middleRows(seg*bs, bs);
+                }
+            }
+            // Back substitution, from the roots.
+            for (const int seg : order_) {
+                const int out = outlet_[seg];
+                if (out >= 0) {
+                    x.middleRows(seg*bs, bs) -= eliminated_[seg] * x.middleRows(out*bs, bs);
+                }
+            }
+        }
+
+    private:
+        std::vector<int> outlet_;
+        int block_size_;
+        // Segments ordered from the roots, each after its outlet.
+        std::vector<int> order_;
+        std::vector<Block> diagonal_;
+        std::vector<Block> to_outlet_;
+        std::vector<Block> from_outlet_;
+        // Factorized Schur complement of each segment.
+        std::vector<Eigen::PartialPivLU<Block>> lu_;
+        // Inverse of the Schur complement times toOutlet(), for each segment.
+        std::vector<Block> eliminated_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
@@ -30,6 +30,7 @@
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/RateConverter.hpp>
+#include <opm/autodiff/StepStartHistory.hpp>
 
 #include <opm/core/grid.h>
 #include <opm/core/wells.h>
@@ -191,6 +192,9 @@ namespace Opm
         std::vector<double> threshold_pressures_by_face_;
         // Whether this a parallel simulation or not
         bool is_parallel_run_;
+        // Start-of-step variables of the time steps, shared by the
+        // models of all report steps.
+        std::shared_ptr<StepStartHistory> step_history_;
     };
 
 } // namespace Opm
@@ -55,7 +55,8 @@ namespace Opm
           output_writer_(output_writer),
           rateConverter_(props_, std::vector<int>(AutoDiffGrid::numCells(grid_), 0)),
           threshold_pressures_by_face_(threshold_pressures_by_face),
-          is_parallel_run_( false )
+          is_parallel_run_( false ),
+          step_history_(std::make_shared<StepStartHistory>())
     {
         // Misc init.
         const int num_cells = AutoDiffGrid::numCells(grid);
@@ -376,6 +377,7 @@ namespace Opm
         if (!threshold_pressures_by_face_.empty()) {
             model->setThresholdPressures(threshold_pressures_by_face_);
         }
+        model->setStepStartHistory(step_history_);
 
         return std::unique_ptr<Solver>(new Solver(solver_param_, std::move(model)));
     }
@@ -393,6 +395,10 @@ namespace Opm
 
         const std::vector<int>& resv_wells = SimFIBODetails::resvWells(wells, step, wmap);
 
+        // The FIP regions are ignored when converting the rates below, so
+        // all RESV wells use region 0 and only that region is needed.
+        const std::vector<int> resv_regions(1, 0);
+
         const std::size_t number_resv_wells        = resv_wells.size();
         std::size_t       global_number_resv_wells = number_resv_wells;
 #if HAVE_MPI
@@ -407,7 +413,7 @@ namespace Opm
                 // to calculate averages over regions that might cross process
                 // borders. This needs to be done by all processes and therefore
                 // outside of the next if statement.
-                rateConverter_.defineState(x, boost::any_cast<const ParallelISTLInformation&>(solver_.parallelInformation()));
+                rateConverter_.defineState(x, solver_.parallelInformation(), resv_regions);
             }
         }
         else
@@ -415,7 +421,7 @@ namespace Opm
         {
             if ( global_number_resv_wells )
             {
-                rateConverter_.defineState(x);
+                rateConverter_.defineState(x, boost::any(), resv_regions);
             }
         }
 
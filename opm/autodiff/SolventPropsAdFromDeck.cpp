@@ -87,9 +87,9 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     inverseBmu[i] = 1.0 / (b[i] * visc[i]);
                 }
 
-                b_[regionIdx] = NonuniformTableLinear<double>(press, inverseB);
-                viscosity_[regionIdx] = NonuniformTableLinear<double>(press, visc);
-                inverseBmu_[regionIdx] = NonuniformTableLinear<double>(press, inverseBmu);
+                b_[regionIdx] = CompiledTableLinear(press, inverseB);
+                viscosity_[regionIdx] = CompiledTableLinear(press, visc);
+                inverseBmu_[regionIdx] = CompiledTableLinear(press, inverseBmu);
             }
         } else {
             OPM_THROW(std::runtime_error, "PVDS must be specified in SOLVENT runs\n");
@@ -112,8 +112,8 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                 const auto& krg = ssfnTable.getGasRelPermMultiplierColumn();
                 const auto& krs = ssfnTable.getSolventRelPermMultiplierColumn();
 
-                krg_[regionIdx] = NonuniformTableLinear<double>(solventFraction, krg);
-                krs_[regionIdx] = NonuniformTableLinear<double>(solventFraction, krs);
+                krg_[regionIdx] = CompiledTableLinear(solventFraction, krg);
+                krs_[regionIdx] = CompiledTableLinear(solventFraction, krs);
             }
 
         } else {
@@ -144,7 +144,7 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& sn = sof2Table.getSoColumn();
                     const auto& krn = sof2Table.getKroColumn();
 
-                    krn_[regionIdx] = NonuniformTableLinear<double>(sn, krn);
+                    krn_[regionIdx] = CompiledTableLinear(sn, krn);
                 }
 
             } else {
@@ -166,7 +166,7 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& solventFraction = miscTable.getSolventFractionColumn();
                     const auto& misc = miscTable.getMiscibilityColumn();
 
-                    misc_[regionIdx] = NonuniformTableLinear<double>(solventFraction, misc);
+                    misc_[regionIdx] = CompiledTableLinear(solventFraction, misc);
 
                 }
             } else {
@@ -187,7 +187,7 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& po = pmiscTable.getOilPhasePressureColumn();
                     const auto& pmisc = pmiscTable.getMiscibilityColumn();
 
-                    pmisc_[regionIdx] = NonuniformTableLinear<double>(po, pmisc);
+                    pmisc_[regionIdx] = CompiledTableLinear(po, pmisc);
 
                 }
             }
@@ -210,8 +210,8 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& krsg = msfnTable.getGasSolventRelpermMultiplierColumn();
                     const auto& kro = msfnTable.getOilRelpermMultiplierColumn();
 
-                    mkrsg_[regionIdx] = NonuniformTableLinear<double>(Ssg, krsg);
-                    mkro_[regionIdx] = NonuniformTableLinear<double>(Ssg, kro);
+                    mkrsg_[regionIdx] = CompiledTableLinear(Ssg, krsg);
+                    mkro_[regionIdx] = CompiledTableLinear(Ssg, kro);
 
                 }
             }
@@ -230,7 +230,7 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& sw = sorwmisTable.getWaterSaturationColumn();
                     const auto& sorwmis = sorwmisTable.getMiscibleResidualOilColumn();
 
-                    sorwmis_[regionIdx] = NonuniformTableLinear<double>(sw, sorwmis);
+                    sorwmis_[regionIdx] = CompiledTableLinear(sw, sorwmis);
                 }
             }
 
@@ -248,7 +248,7 @@ SolventPropsAdFromDeck::SolventPropsAdFromDeck(DeckConstPtr deck,
                     const auto& sw = sgcwmisTable.getWaterSaturationColumn();
                     const auto& sgcwmis = sgcwmisTable.getMiscibleResidualGasColumn();
 
-                    sgcwmis_[regionIdx] = NonuniformTableLinear<double>(sw, sgcwmis);
+                    sgcwmis_[regionIdx] = CompiledTableLinear(sw, sgcwmis);
                 }
             }
 
@@ -392,15 +392,13 @@ ADB SolventPropsAdFromDeck::miscibleResidualOilSaturationFunction (const ADB& Sw
 ADB SolventPropsAdFromDeck::makeADBfromTables(const ADB& X_AD,
                                               const Cells& cells,
                                               const std::vector<int>& regionIdx,
-                                              const std::vector<NonuniformTableLinear<double>>& tables) const {
+                                              const std::vector<CompiledTableLinear>& tables) const {
     const int n = cells.size();
     assert(X_AD.value().size() == n);
     V x(n);
     V dx(n);
     for (int i = 0; i < n; ++i) {
-        const double& X_i = X_AD.value()[i];
-        x[i] = tables[regionIdx[cells[i]]](X_i);
-        dx[i] = tables[regionIdx[cells[i]]].derivative(X_i);
+        tables[regionIdx[cells[i]]].evaluate(X_AD.value()[i], x[i], dx[i]);
     }
 
     ADB::M dx_diag(dx.matrix().asDiagonal());
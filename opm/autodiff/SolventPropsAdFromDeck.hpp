@@ -22,8 +22,7 @@
 
 #include <opm/autodiff/BlackoilPropsAdInterface.hpp>
 #include <opm/autodiff/AutoDiffBlock.hpp>
-
-#include <opm/core/utility/NonuniformTableLinear.hpp>
+#include <opm/autodiff/CompiledTableLinear.hpp>
 
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
@@ -153,7 +152,7 @@ private:
     ADB makeADBfromTables(const ADB& X,
                           const Cells& cells,
                           const std::vector<int>& regionIdx,
-                          const std::vector<NonuniformTableLinear<double>>& tables) const;
+                          const std::vector<CompiledTableLinear>& tables) const;
 
     /// Helper function to create an array containing the
     /// table index of for each compressed cell from an Eclipse deck.
@@ -172,19 +171,19 @@ private:
     std::vector<int> cellPvtRegionIdx_;
     std::vector<int> cellMiscRegionIdx_;
     std::vector<int> cellSatNumRegionIdx_;
-    std::vector<NonuniformTableLinear<double> > b_;
-    std::vector<NonuniformTableLinear<double> > viscosity_;
-    std::vector<NonuniformTableLinear<double> > inverseBmu_;
+    std::vector<CompiledTableLinear> b_;
+    std::vector<CompiledTableLinear> viscosity_;
+    std::vector<CompiledTableLinear> inverseBmu_;
     std::vector<double> solvent_surface_densities_;
-    std::vector<NonuniformTableLinear<double> > krg_;
-    std::vector<NonuniformTableLinear<double> > krs_;
-    std::vector<NonuniformTableLinear<double> > krn_;
-    std::vector<NonuniformTableLinear<double> > mkro_;
-    std::vector<NonuniformTableLinear<double> > mkrsg_;
-    std::vector<NonuniformTableLinear<double> > misc_;
-    std::vector<NonuniformTableLinear<double> > pmisc_;
-    std::vector<NonuniformTableLinear<double> > sorwmis_;
-    std::vector<NonuniformTableLinear<double> > sgcwmis_;
+    std::vector<CompiledTableLinear> krg_;
+    std::vector<CompiledTableLinear> krs_;
+    std::vector<CompiledTableLinear> krn_;
+    std::vector<CompiledTableLinear> mkro_;
+    std::vector<CompiledTableLinear> mkrsg_;
+    std::vector<CompiledTableLinear> misc_;
+    std::vector<CompiledTableLinear> pmisc_;
+    std::vector<CompiledTableLinear> sorwmis_;
+    std::vector<CompiledTableLinear> sgcwmis_;
     std::vector<double> mix_param_viscosity_;
     std::vector<double> mix_param_density_;
 };
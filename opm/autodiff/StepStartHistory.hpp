@@ -0,0 +1,67 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_STEPSTARTHISTORY_HEADER_INCLUDED
+#define OPM_STEPSTARTHISTORY_HEADER_INCLUDED
+
+#include <Eigen/Eigen>
+
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// Primary variable values at the start of time steps, used to
+    /// extrapolate the initial guess of the next time step.
+    ///
+    /// The simulators create a new model for each report step, so the
+    /// history is owned by the simulator and handed to each model it
+    /// creates. The extrapolation then also works across report steps.
+    struct StepStartHistory
+    {
+        typedef Eigen::Array<double, Eigen::Dynamic, 1> V;
+        typedef Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> DataBlock;
+
+        struct Variables
+        {
+            Variables() : dt(0.0) {}
+            V         pressure;
+            DataBlock saturation;
+            V         rs;
+            V         rv;
+            V         bhp;
+            V         well_rates;
+            std::vector<std::string> well_names;
+            double    dt;
+        };
+
+        StepStartHistory() : has_last_accepted(false) {}
+
+        /// Variables at the start of the current time step.
+        Variables step_start;
+        /// Variables at the start of the last accepted time step.
+        Variables last_accepted;
+        /// True if last_accepted holds an accepted time step.
+        bool has_last_accepted;
+    };
+
+} // namespace Opm
+
+#endif // OPM_STEPSTARTHISTORY_HEADER_INCLUDED
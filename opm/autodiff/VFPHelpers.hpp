@@ -26,6 +26,8 @@
 #include <opm/parser/eclipse/EclipseState/Tables/VFPInjTable.hpp>
 #include <opm/autodiff/AutoDiffHelpers.hpp>
 
+#include <algorithm>
+
 
 /**
  * This file contains a set of helper functions used by VFPProd / VFPInj.
@@ -206,57 +208,62 @@ struct InterpData {
  * Helper function to find indices etc. for linear interpolation and extrapolation
  *  @param value Value to find in values
  *  @param values Sorted list of values to search for value in.
+ *  @param bracket On input, the index of the first end point of the interval
+ *         used in a previous call. This interval and its two neighbours are
+ *         tried before searching all of values, as the value typically
+ *         changes little between Newton iterations. On output, the index of
+ *         the first end point of the interval used.
  *  @return Data required to find the interpolated value
  */
-inline InterpData findInterpData(const double& value, const std::vector<double>& values) {
+inline InterpData findInterpData(const double& value, const std::vector<double>& values, int& bracket) {
     InterpData retval;
 
     const int nvalues = values.size();
 
     //If we only have one value in our vector, return that
-    if (values.size() == 1) {
-        retval.ind_[0] = 0;
-        retval.ind_[1] = 0;
-        retval.inv_dist_ = 0.0;
-        retval.factor_ = 0.0;
+    if (nvalues == 1) {
+        bracket = 0;
+        return retval;
     }
-    // Else search in the vector
-    else {
-        //If value is less than all values, use first interval
-        if (value < values.front()) {
-            retval.ind_[0] = 0;
-            retval.ind_[1] = 1;
-        }
-        //If value is greater than all values, use last interval
-        else if (value >= values.back()) {
-            retval.ind_[0] = nvalues-2;
-            retval.ind_[1] = nvalues-1;
-        }
-        else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
-            }
+
+    //The interval [values[i], values[i+1]] is used if values[i] < value <= values[i+1],
+    //with the first and last intervals also used for extrapolation.
+    const int last = nvalues-2;
+    auto contains = [&](const int i) {
+        return (i == 0 || values[i] < value) && (i == last || value <= values[i+1]);
+    };
+
+    int ind = -1;
+    const int candidates[3] = { bracket, bracket+1, bracket-1 };
+    for (const int i : candidates) {
+        if (i >= 0 && i <= last && contains(i)) {
+            ind = i;
+            break;
         }
+    }
+    if (ind < 0) {
+        //Binary search for the first element greater than or equal to value
+        const int upper = std::lower_bound(values.begin(), values.end(), value) - values.begin();
+        ind = std::min(std::max(upper-1, 0), last);
+    }
+    bracket = ind;
 
-        const double start = values[retval.ind_[0]];
-        const double end   = values[retval.ind_[1]];
+    retval.ind_[0] = ind;
+    retval.ind_[1] = ind+1;
 
-        //Find interpolation ratio
-        if (end > start) {
-            //FIXME: Possible source for floating point error here if value and floor are large,
-            //but very close to each other
-            retval.inv_dist_ = 1.0 / (end-start);
-            retval.factor_ = (value-start) * retval.inv_dist_;
-        }
-        else {
-            retval.inv_dist_ = 0.0;
-            retval.factor_ = 0.0;
-        }
+    const double start = values[retval.ind_[0]];
+    const double end   = values[retval.ind_[1]];
+
+    //Find interpolation ratio
+    if (end > start) {
+        //FIXME: Possible source for floating point error here if value and floor are large,
+        //but very close to each other
+        retval.inv_dist_ = 1.0 / (end-start);
+        retval.factor_ = (value-start) * retval.inv_dist_;
+    }
+    else {
+        retval.inv_dist_ = 0.0;
+        retval.factor_ = 0.0;
     }
 
     return retval;
@@ -264,6 +271,19 @@ inline InterpData findInterpData(const double& value, const std::vector<double>&
 
 
 
+/**
+ * Helper function to find indices etc. for linear interpolation and extrapolation
+ *  @param value Value to find in values
+ *  @param values Sorted list of values to search for value in.
+ *  @return Data required to find the interpolated value
+ */
+inline InterpData findInterpData(const double& value, const std::vector<double>& values) {
+    int bracket = 0;
+    return findInterpData(value, values, bracket);
+}
+
+
+
 
 
 
@@ -347,21 +367,25 @@ inline VFPEvaluation interpolate(
     //This is not really required, but performance-wise it may pay off, since the 32-elements
     //we copy to (nn) will fit better in cache than the full original table for the
     //interpolation below.
+    //The table is stored contiguously, so the elements are addressed directly through
+    //the strides instead of through the nested multi_array views.
+    const double* data = array.origin();
+    const auto* strides = array.strides();
+    const int toff[2] = { int(thp_i.ind_[0]*strides[0]), int(thp_i.ind_[1]*strides[0]) };
+    const int woff[2] = { int(wfr_i.ind_[0]*strides[1]), int(wfr_i.ind_[1]*strides[1]) };
+    const int goff[2] = { int(gfr_i.ind_[0]*strides[2]), int(gfr_i.ind_[1]*strides[2]) };
+    const int aoff[2] = { int(alq_i.ind_[0]*strides[3]), int(alq_i.ind_[1]*strides[3]) };
+    const int foff[2] = { int(flo_i.ind_[0]*strides[4]), int(flo_i.ind_[1]*strides[4]) };
+
     //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
     for (int t=0; t<=1; ++t) {
         for (int w=0; w<=1; ++w) {
             for (int g=0; g<=1; ++g) {
                 for (int a=0; a<=1; ++a) {
+                    const double* row = data + toff[t] + woff[w] + goff[g] + aoff[a];
                     for (int f=0; f<=1; ++f) {
-                        //Shorthands for indexing
-                        const int ti = thp_i.ind_[t];
-                        const int wi = wfr_i.ind_[w];
-                        const int gi = gfr_i.ind_[g];
-                        const int ai = alq_i.ind_[a];
-                        const int fi = flo_i.ind_[f];
-
                         //Copy element
-                        nn[t][w][g][a][f].value = array[ti][wi][gi][ai][fi];
+                        nn[t][w][g][a][f].value = row[foff[f]];
                     }
                 }
             }
@@ -973,6 +997,62 @@ inline double findTHP(
 
 
 
+/**
+ * This function finds the value of FLO giving a specific BHP, with the
+ * other table variables fixed.
+ * Essentially:
+ *   Given the function f(flo_array(x)) = bhp_array(x), which is piecewise linear,
+ *   find flo so that f(flo) = bhp.
+ * f is in general not monotone: at low rates the hydrostatic head dominates,
+ * at high rates the friction does. The segments are therefore searched
+ * from the highest rate, so that the largest rate giving bhp is found.
+ * @return The flo, or zero if no non-negative flo gives bhp.
+ */
+inline double findFlo(
+        const std::vector<double>& bhp_array,
+        const std::vector<double>& flo_array,
+        double bhp) {
+    const int nflo = flo_array.size();
+
+    //Check that our flo axis is sorted
+    assert(std::is_sorted(flo_array.begin(), flo_array.end()));
+
+    //A single value cannot be inverted
+    if (nflo == 1) {
+        return flo_array[0];
+    }
+
+    //Extrapolation beyond the largest rate in the table
+    const double flo_right = detail::findX(flo_array[nflo-2], flo_array[nflo-1],
+                                           bhp_array[nflo-2], bhp_array[nflo-1], bhp);
+    if (bhp_array[nflo-1] != bhp_array[nflo-2] && flo_right > flo_array[nflo-1]) {
+        //TODO: LOG extrapolation
+        return flo_right;
+    }
+
+    //Monotone segments containing bhp, searched from the highest rate
+    for (int i=nflo-2; i>=0; --i) {
+        const double& y0 = bhp_array[i  ];
+        const double& y1 = bhp_array[i+1];
+
+        if (std::min(y0, y1) <= bhp && bhp <= std::max(y0, y1)) {
+            return detail::findX(flo_array[i], flo_array[i+1], y0, y1, bhp);
+        }
+    }
+
+    //Extrapolation below the smallest rate in the table
+    //TODO: LOG extrapolation
+    const double flo_left = detail::findX(flo_array[0], flo_array[1],
+                                          bhp_array[0], bhp_array[1], bhp);
+    return std::max(std::min(flo_left, flo_array[0]), 0.0);
+}
+
+
+
+
+
+
+
 } // namespace detail
 
 
@@ -124,13 +124,19 @@ VFPInjProperties::ADB VFPInjProperties::bhp(const std::vector<int>& table_id,
     //Get the right FLO variable for each well as a single ADB
     const ADB flo = detail::combineADBVars<VFPInjTable::FLO_TYPE>(well_tables, aqua, liquid, vapour);
 
+    //Start the interval searches from those of the last call
+    if (static_cast<int>(m_brackets.size()) != 2*nw) {
+        m_brackets.assign(2*nw, 0);
+    }
+
     //Compute the BHP for each well independently
     for (int i=0; i<nw; ++i) {
         const VFPInjTable* table = well_tables[i];
         if (table != nullptr) {
             //First, find the values to interpolate between
-            auto flo_i = detail::findInterpData(flo.value()[i], table->getFloAxis());
-            auto thp_i = detail::findInterpData(thp_arg.value()[i], table->getTHPAxis());
+            int* bracket = &m_brackets[2*i];
+            auto flo_i = detail::findInterpData(flo.value()[i], table->getFloAxis(), bracket[0]);
+            auto thp_i = detail::findInterpData(thp_arg.value()[i], table->getTHPAxis(), bracket[1]);
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i);
 
@@ -210,8 +216,9 @@ double VFPInjProperties::thp(int table_id,
      */
     auto flo_i = detail::findInterpData(flo, table->getFloAxis());
     std::vector<double> bhp_array(nthp);
+    int thp_bracket = 0;
     for (int i=0; i<nthp; ++i) {
-        auto thp_i = detail::findInterpData(thp_array[i], thp_array);
+        auto thp_i = detail::findInterpData(thp_array[i], thp_array, thp_bracket);
         bhp_array[i] = detail::interpolate(data, flo_i, thp_i).value;
     }
 
@@ -224,6 +231,54 @@ double VFPInjProperties::thp(int table_id,
 
 
 
+double VFPInjProperties::flo(int table_id,
+        const double& bhp_arg,
+        const double& thp_arg) const {
+    const VFPInjTable* table = detail::getTable(m_tables, table_id);
+    const VFPInjTable::array_type& data = table->getTable();
+
+    const std::vector<double>& flo_array = table->getFloAxis();
+    int nflo = flo_array.size();
+
+    /**
+     * Find the function bhp_array(flo) by creating a 1D view of the data
+     * by interpolating for every value of flo, as in thp().
+     */
+    auto thp_i = detail::findInterpData(thp_arg, table->getTHPAxis());
+    std::vector<double> bhp_array(nflo);
+    int flo_bracket = 0;
+    for (int i=0; i<nflo; ++i) {
+        auto flo_i = detail::findInterpData(flo_array[i], flo_array, flo_bracket);
+        bhp_array[i] = detail::interpolate(data, flo_i, thp_i).value;
+    }
+
+    double retval = detail::findFlo(bhp_array, flo_array, bhp_arg);
+    return retval;
+}
+
+
+
+double VFPInjProperties::rateScaling(int table_id,
+        const double& aqua,
+        const double& liquid,
+        const double& vapour,
+        const double& bhp_arg,
+        const double& thp_arg) const {
+    const VFPInjTable* table = detail::getTable(m_tables, table_id);
+
+    double flo_rates = detail::getFlo(aqua, liquid, vapour, table->getFloType());
+    if (flo_rates <= 0.0) {
+        return 0.0;
+    }
+
+    return flo(table_id, bhp_arg, thp_arg) / flo_rates;
+}
+
+
+
+
+
+
 const VFPInjTable* VFPInjProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
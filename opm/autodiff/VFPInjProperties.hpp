@@ -126,6 +126,40 @@ public:
             const double& vapour,
             const double& bhp) const;
 
+    /**
+     * Linear interpolation of the flow rate as a function of the input parameters,
+     * i.e., the inverse of bhp() with respect to the rate.
+     * @param table_id Table number to use
+     * @param bhp Bottom hole pressure
+     * @param thp Tubing head pressure
+     *
+     * @return The largest FLO, of the type given by the table, for which the
+     * interpolated/extrapolated bhp equals bhp, or zero if there is none.
+     */
+    double flo(int table_id,
+            const double& bhp,
+            const double& thp) const;
+
+    /**
+     * Scaling of the given rates, keeping their phase fractions, for which
+     * the interpolated/extrapolated bhp equals bhp. See flo().
+     * @param table_id Table number to use
+     * @param aqua Water phase
+     * @param liquid Oil phase
+     * @param vapour Gas phase
+     * @param bhp Bottom hole pressure
+     * @param thp Tubing head pressure
+     *
+     * @return The factor to multiply the rates with, or zero if there is
+     * none or the FLO of the rates is not positive.
+     */
+    double rateScaling(int table_id,
+            const double& aqua,
+            const double& liquid,
+            const double& vapour,
+            const double& bhp,
+            const double& thp) const;
+
     /**
      * Returns the table associated with the ID, or throws an exception if
      * the table does not exist
@@ -142,6 +176,12 @@ public:
 private:
     // Map which connects the table number with the table itself
     std::map<int, const VFPInjTable*> m_tables;
+
+    // Interpolation intervals used for each well in the last call to the
+    // ADB version of bhp(), 2 axes per well, used as starting points
+    // for the interval searches of the next call. Calls of this version
+    // of bhp() must therefore not be made concurrently.
+    mutable std::vector<int> m_brackets;
 };
 
 
@@ -116,17 +116,23 @@ VFPProdProperties::ADB VFPProdProperties::bhp(const std::vector<int>& table_id,
     const ADB wfr = detail::combineADBVars<VFPProdTable::WFR_TYPE>(well_tables, aqua, liquid, vapour);
     const ADB gfr = detail::combineADBVars<VFPProdTable::GFR_TYPE>(well_tables, aqua, liquid, vapour);
 
+    //Start the interval searches from those of the last call
+    if (static_cast<int>(m_brackets.size()) != 5*nw) {
+        m_brackets.assign(5*nw, 0);
+    }
+
     //Compute the BHP for each well independently
     for (int i=0; i<nw; ++i) {
         const VFPProdTable* table = well_tables[i];
         if (table != nullptr) {
             //First, find the values to interpolate between
             //Value of FLO is negative in OPM for producers, but positive in VFP table
-            auto flo_i = detail::findInterpData(-flo.value()[i], table->getFloAxis());
-            auto thp_i = detail::findInterpData( thp_arg.value()[i], table->getTHPAxis());
-            auto wfr_i = detail::findInterpData( wfr.value()[i], table->getWFRAxis());
-            auto gfr_i = detail::findInterpData( gfr.value()[i], table->getGFRAxis());
-            auto alq_i = detail::findInterpData( alq.value()[i], table->getALQAxis());
+            int* bracket = &m_brackets[5*i];
+            auto flo_i = detail::findInterpData(-flo.value()[i], table->getFloAxis(), bracket[0]);
+            auto thp_i = detail::findInterpData( thp_arg.value()[i], table->getTHPAxis(), bracket[1]);
+            auto wfr_i = detail::findInterpData( wfr.value()[i], table->getWFRAxis(), bracket[2]);
+            auto gfr_i = detail::findInterpData( gfr.value()[i], table->getGFRAxis(), bracket[3]);
+            auto alq_i = detail::findInterpData( alq.value()[i], table->getALQAxis(), bracket[4]);
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
@@ -222,8 +228,9 @@ double VFPProdProperties::thp(int table_id,
     auto gfr_i = detail::findInterpData( gfr, table->getGFRAxis());
     auto alq_i = detail::findInterpData( alq, table->getALQAxis());
     std::vector<double> bhp_array(nthp);
+    int thp_bracket = 0;
     for (int i=0; i<nthp; ++i) {
-        auto thp_i = detail::findInterpData(thp_array[i], thp_array);
+        auto thp_i = detail::findInterpData(thp_array[i], thp_array, thp_bracket);
         bhp_array[i] = detail::interpolate(data, flo_i, thp_i, wfr_i, gfr_i, alq_i).value;
     }
 
@@ -236,6 +243,64 @@ double VFPProdProperties::thp(int table_id,
 
 
 
+double VFPProdProperties::flo(int table_id,
+        const double& bhp_arg,
+        const double& thp_arg,
+        const double& wfr,
+        const double& gfr,
+        const double& alq) const {
+    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+    const VFPProdTable::array_type& data = table->getTable();
+
+    const std::vector<double>& flo_array = table->getFloAxis();
+    int nflo = flo_array.size();
+
+    /**
+     * Find the function bhp_array(flo) by creating a 1D view of the data
+     * by interpolating for every value of flo, as in thp().
+     */
+    auto thp_i = detail::findInterpData(thp_arg, table->getTHPAxis());
+    auto wfr_i = detail::findInterpData(wfr, table->getWFRAxis());
+    auto gfr_i = detail::findInterpData(gfr, table->getGFRAxis());
+    auto alq_i = detail::findInterpData(alq, table->getALQAxis());
+    std::vector<double> bhp_array(nflo);
+    int flo_bracket = 0;
+    for (int i=0; i<nflo; ++i) {
+        auto flo_i = detail::findInterpData(flo_array[i], flo_array, flo_bracket);
+        bhp_array[i] = detail::interpolate(data, flo_i, thp_i, wfr_i, gfr_i, alq_i).value;
+    }
+
+    double retval = detail::findFlo(bhp_array, flo_array, bhp_arg);
+    return retval;
+}
+
+
+
+double VFPProdProperties::rateScaling(int table_id,
+        const double& aqua,
+        const double& liquid,
+        const double& vapour,
+        const double& bhp_arg,
+        const double& thp_arg,
+        const double& alq) const {
+    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+
+    //Recall that flo is negative in Opm, so switch the sign
+    double flo_rates = -detail::getFlo(aqua, liquid, vapour, table->getFloType());
+    if (flo_rates <= 0.0) {
+        return 0.0;
+    }
+    double wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
+    double gfr = detail::getGFR(aqua, liquid, vapour, table->getGFRType());
+
+    return flo(table_id, bhp_arg, thp_arg, wfr, gfr, alq) / flo_rates;
+}
+
+
+
+
+
+
 const VFPProdTable* VFPProdProperties::getTable(const int table_id) const {
     return detail::getTable(m_tables, table_id);
 }
@@ -137,6 +137,49 @@ public:
             const double& bhp,
             const double& alq) const;
 
+    /**
+     * Linear interpolation of the flow rate as a function of the input parameters,
+     * i.e., the inverse of bhp() with respect to the rate.
+     * @param table_id Table number to use
+     * @param bhp Bottom hole pressure
+     * @param thp Tubing head pressure
+     * @param wfr Water fraction, of the type given by the table
+     * @param gfr Gas fraction, of the type given by the table
+     * @param alq Artificial lift or other parameter
+     *
+     * @return The largest FLO, of the type given by the table and positive for
+     * production, for which the interpolated/extrapolated bhp equals bhp, or
+     * zero if there is none.
+     */
+    double flo(int table_id,
+            const double& bhp,
+            const double& thp,
+            const double& wfr,
+            const double& gfr,
+            const double& alq) const;
+
+    /**
+     * Scaling of the given rates, keeping their phase fractions, for which
+     * the interpolated/extrapolated bhp equals bhp. See flo().
+     * @param table_id Table number to use
+     * @param aqua Water phase
+     * @param liquid Oil phase
+     * @param vapour Gas phase
+     * @param bhp Bottom hole pressure
+     * @param thp Tubing head pressure
+     * @param alq Artificial lift or other parameter
+     *
+     * @return The factor to multiply the rates with, or zero if there is
+     * none or the FLO of the rates is not positive for production.
+     */
+    double rateScaling(int table_id,
+            const double& aqua,
+            const double& liquid,
+            const double& vapour,
+            const double& bhp,
+            const double& thp,
+            const double& alq) const;
+
     /**
      * Returns the table associated with the ID, or throws an exception if
      * the table does not exist
@@ -153,6 +196,12 @@ public:
 private:
     // Map which connects the table number with the table itself
     std::map<int, const VFPProdTable*> m_tables;
+
+    // Interpolation intervals used for each well in the last call to the
+    // ADB version of bhp(), 5 axes per well, used as starting points
+    // for the interval searches of the next call. Calls of this version
+    // of bhp() must therefore not be made concurrently.
+    mutable std::vector<int> m_brackets;
 };
 
 
@@ -22,7 +22,7 @@
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/core/props/BlackoilPhases.hpp>
-#include <numeric>
+#include <algorithm>
 #include <cmath>
 
 
@@ -64,79 +64,74 @@ Opm::WellDensitySegmented::computeConnectionDensities(const Wells& wells,
         }
     }
 
-    // 1. Compute the flow (in surface volume units for each
-    //    component) exiting up the wellbore from each perforation,
-    //    taking into account flow from lower in the well, and
-    //    in/out-flow at each perforation.
-    std::vector<double> q_out_perf(nperf*np);
-    for (int w = 0; w < nw; ++w) {
-        // Iterate over well perforations from bottom to top.
-        for (int perf = wells.well_connpos[w+1] - 1; perf >= wells.well_connpos[w]; --perf) {
-            for (int phase = 0; phase < np; ++phase) {
-                if (perf == wells.well_connpos[w+1] - 1) {
-                    // This is the bottom perforation. No flow from below.
-                    q_out_perf[perf*np + phase] = 0.0;
-                } else {
-                    // Set equal to flow from below.
-                    q_out_perf[perf*np + phase] = q_out_perf[(perf+1)*np + phase];
-                }
-                // Subtract outflow through perforation.
-                q_out_perf[perf*np + phase] -= wstate.perfPhaseRates()[perf*np + phase];
-            }
-        }
-    }
-
-    // 2. Compute the component mix at each perforation as the
-    //    absolute values of the surface rates divided by their sum.
-    //    Then compute volume ratios (formation factors) for each perforation.
-    //    Finally compute densities for the segments associated with each perforation.
+    // The wells are independent, and the perforations of each well
+    // are contiguous, so the wells are processed in parallel, each in
+    // a single pass over its perforations.
     const int gaspos = phase_usage.phase_pos[BlackoilPhases::Vapour];
     const int oilpos = phase_usage.phase_pos[BlackoilPhases::Liquid];
-    std::vector<double> mix(np);
-    std::vector<double> x(np);
-    std::vector<double> surf_dens(np);
+    const double* perf_rates = wstate.perfPhaseRates().data();
     std::vector<double> dens(nperf);
-    for (int w = 0; w < nw; ++w) {
-        for (int perf = wells.well_connpos[w]; perf < wells.well_connpos[w+1]; ++perf) {
-            // Find component mix.
-            const double tot_surf_rate = std::accumulate(q_out_perf.begin() + np*perf,
-                                                         q_out_perf.begin() + np*(perf+1), 0.0);
-            if (tot_surf_rate != 0.0) {
+#pragma omp parallel
+    {
+        std::vector<double> q_out(np);
+        std::vector<double> mix(np);
+        std::vector<double> x(np);
+#pragma omp for schedule(dynamic)
+        for (int w = 0; w < nw; ++w) {
+            // Iterate over well perforations from bottom to top.
+            std::fill(q_out.begin(), q_out.end(), 0.0);
+            for (int perf = wells.well_connpos[w+1] - 1; perf >= wells.well_connpos[w]; --perf) {
+                // 1. Compute the flow (in surface volume units for each
+                //    component) exiting up the wellbore from each perforation,
+                //    taking into account flow from lower in the well, and
+                //    in/out-flow at each perforation.
+                double tot_surf_rate = 0.0;
                 for (int phase = 0; phase < np; ++phase) {
-                    mix[phase] = std::fabs(q_out_perf[perf*np + phase]/tot_surf_rate);
+                    // Subtract outflow through perforation from the flow from below.
+                    q_out[phase] -= perf_rates[perf*np + phase];
+                    tot_surf_rate += q_out[phase];
                 }
-            } else {
-                // No flow => use well specified fractions for mix.
-                std::copy(wells.comp_frac + w*np, wells.comp_frac + (w+1)*np, mix.begin());
-            }
-            // Compute volume ratio.
-            x = mix;
-            double rs = 0.0;
-            double rv = 0.0;
-            if (!rsmax_perf.empty() && mix[oilpos] > 0.0) {
-                rs = std::min(mix[gaspos]/mix[oilpos], rsmax_perf[perf]);
-            }
-            if (!rvmax_perf.empty() && mix[gaspos] > 0.0) {
-                rv = std::min(mix[oilpos]/mix[gaspos], rvmax_perf[perf]);
-            }
-            if (rs != 0.0) {
-                // Subtract gas in oil from gas mixture
-                x[gaspos] = (mix[gaspos] - mix[oilpos]*rs)/(1.0 - rs*rv);
-            }
-            if (rv != 0.0) {
-                // Subtract oil in gas from oil mixture
-                x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);;
-            }
-            double volrat = 0.0;
-            for (int phase = 0; phase < np; ++phase) {
-                volrat += x[phase] / b_perf[perf*np + phase];
-            }
-            for (int phase = 0; phase < np; ++phase) {
-                surf_dens[phase] = surf_dens_perf[perf*np + phase];
-            }
 
-            // Compute segment density.
-            dens[perf] = std::inner_product(surf_dens.begin(), surf_dens.end(), mix.begin(), 0.0) / volrat;
+                // 2. Compute the component mix at each perforation as the
+                //    absolute values of the surface rates divided by their sum.
+                //    Then compute volume ratios (formation factors) for each perforation.
+                //    Finally compute densities for the segments associated with each perforation.
+                if (tot_surf_rate != 0.0) {
+                    for (int phase = 0; phase < np; ++phase) {
+                        mix[phase] = std::fabs(q_out[phase]/tot_surf_rate);
+                    }
+                } else {
+                    // No flow => use well specified fractions for mix.
+                    std::copy(wells.comp_frac + w*np, wells.comp_frac + (w+1)*np, mix.begin());
+                }
+                // Compute volume ratio.
+                x = mix;
+                double rs = 0.0;
+                double rv = 0.0;
+                if (!rsmax_perf.empty() && mix[oilpos] > 0.0) {
+                    rs = std::min(mix[gaspos]/mix[oilpos], rsmax_perf[perf]);
+                }
+                if (!rvmax_perf.empty() && mix[gaspos] > 0.0) {
+                    rv = std::min(mix[oilpos]/mix[gaspos], rvmax_perf[perf]);
+                }
+                if (rs != 0.0) {
+                    // Subtract gas in oil from gas mixture
+                    x[gaspos] = (mix[gaspos] - mix[oilpos]*rs)/(1.0 - rs*rv);
+                }
+                if (rv != 0.0) {
+                    // Subtract oil in gas from oil mixture
+                    x[oilpos] = (mix[oilpos] - mix[gaspos]*rv)/(1.0 - rs*rv);;
+                }
+                double volrat = 0.0;
+                double surf_dens = 0.0;
+                for (int phase = 0; phase < np; ++phase) {
+                    volrat += x[phase] / b_perf[perf*np + phase];
+                    surf_dens += surf_dens_perf[perf*np + phase] * mix[phase];
+                }
+
+                // Compute segment density.
+                dens[perf] = surf_dens / volrat;
+            }
         }
     }
 
@@ -171,28 +166,26 @@ Opm::WellDensitySegmented::computeConnectionPressureDelta(const Wells& wells,
     // Our goal is to compute a pressure delta for each perforation.
 
     // 1. Compute pressure differences between perforations.
-    //    dp_perf will contain the pressure difference between a
-    //    perforation and the one above it, except for the first
-    //    perforation for each well, for which it will be the
-    //    difference to the reference (bhp) depth.
+    //    The pressure difference between a perforation and the one
+    //    above it, except for the first perforation for each well,
+    //    for which it is the difference to the reference (bhp) depth.
+    // 2. Compute pressure differences to the reference point (bhp) by
+    //    accumulating the adjacent pressure differences, storing the
+    //    result in dp_perf.
+    //    This accumulation must be done per well, so the wells are
+    //    processed in parallel.
     std::vector<double> dp_perf(nperf);
+#pragma omp parallel for schedule(static)
     for (int w = 0; w < nw; ++w) {
+        double z_above = wells.depth_ref[w];
+        double dp = 0.0;
         for (int perf = wells.well_connpos[w]; perf < wells.well_connpos[w+1]; ++perf) {
-            const double z_above = perf == wells.well_connpos[w] ? wells.depth_ref[w] : z_perf[perf - 1];
             const double dz = z_perf[perf] - z_above;
-            dp_perf[perf] = dz * dens_perf[perf] * gravity;
+            dp += dz * dens_perf[perf] * gravity;
+            dp_perf[perf] = dp;
+            z_above = z_perf[perf];
         }
     }
 
-    // 2. Compute pressure differences to the reference point (bhp) by
-    //    accumulating the already computed adjacent pressure
-    //    differences, storing the result in dp_perf.
-    //    This accumulation must be done per well.
-    for (int w = 0; w < nw; ++w) {
-        const auto beg = dp_perf.begin() + wells.well_connpos[w];
-        const auto end = dp_perf.begin() + wells.well_connpos[w + 1];
-        std::partial_sum(beg, end, beg);
-    }
-
     return dp_perf;
 }
@@ -22,8 +22,36 @@
 
 #include <Eigen/Core>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace Opm {
 
+namespace detail {
+
+// Smallest outer size (number of columns) for which a sparse matrix
+// operation is split into column ranges, evaluated by separate threads.
+const long partition_min_outer_size = 20000;
+
+// Number of column ranges a sparse matrix operation with the given
+// outer size is split into, 1 if it is to be run serially. An
+// operation that is already run by a thread of a parallel region is
+// not split further.
+inline int numPartitions(const long outer_size)
+{
+#ifdef _OPENMP
+  if (outer_size >= partition_min_outer_size && !omp_in_parallel()) {
+    return omp_get_max_threads();
+  }
+#else
+  static_cast<void>(outer_size);
+#endif
+  return 1;
+}
+
+} // namespace detail
+
 template < unsigned int depth >
 struct QuickSort
 {
@@ -56,6 +84,111 @@ struct QuickSort< 0 >
 };
 
 
+// Computes the columns [begin, end) of lhs*rhs, appending their inner
+// indices and values to the given arrays and storing the number of non
+// zeros of column j in col_nnz[j]. The mask must be all false on entry,
+// and is all false on return.
+template<typename Lhs, typename Rhs, typename Index, typename Scalar>
+void fastSparseProductColumns(const Lhs& lhs, const Rhs& rhs,
+                              const Index begin, const Index end,
+                              std::vector<bool>& mask,
+                              Eigen::Matrix<Scalar,Eigen::Dynamic,1>& values,
+                              Eigen::Matrix<Index,Eigen::Dynamic,1>& indices,
+                              std::vector<Index>& col_nnz,
+                              std::vector<Index>& inner,
+                              std::vector<Scalar>& data)
+{
+  const Scalar epsilon = 0.0;
+  for (Index j=begin; j<end; ++j)
+  {
+    Index nnz = 0;
+    for (typename Rhs::InnerIterator rhsIt(rhs, j); rhsIt; ++rhsIt)
+    {
+      const Scalar y = rhsIt.value();
+      for (typename Lhs::InnerIterator lhsIt(lhs, rhsIt.index()); lhsIt; ++lhsIt)
+      {
+        const Scalar val = lhsIt.value() * y;
+        if( std::abs( val ) > epsilon )
+        {
+          const Index i = lhsIt.index();
+          if(!mask[i])
+          {
+            mask[i] = true;
+            values[i] = val;
+            indices[nnz] = i;
+            ++nnz;
+          }
+          else
+            values[i] += val;
+        }
+      }
+    }
+
+    if( nnz > 1 )
+    {
+      QuickSort< 1 >::sort( indices.data(), indices.data()+nnz );
+    }
+
+    col_nnz[j] = nnz;
+    for(Index k=0; k<nnz; ++k)
+    {
+      const Index i = indices[k];
+      inner.push_back(i);
+      data.push_back(values[i]);
+      mask[i] = false;
+    }
+  }
+}
+
+// Column partitioned version of fastSparseProduct(). Every column is
+// computed exactly as in the serial version, so the result does not
+// depend on the number of partitions.
+template<typename Lhs, typename Rhs, typename ResultType>
+void fastSparseProductPartitioned(const Lhs& lhs, const Rhs& rhs, ResultType& res,
+                                  const int num_parts)
+{
+  typedef typename Eigen::internal::remove_all<Lhs>::type::Scalar Scalar;
+  typedef typename Eigen::internal::remove_all<Lhs>::type::Index Index;
+
+  const Index rows = lhs.innerSize();
+  const Index cols = rhs.outerSize();
+
+  std::vector<Index> col_nnz(cols);
+  std::vector<std::vector<Index> > part_inner(num_parts);
+  std::vector<std::vector<Scalar> > part_data(num_parts);
+#pragma omp parallel for schedule(static) num_threads(num_parts)
+  for (int part = 0; part < num_parts; ++part)
+  {
+    const Index begin = (cols * part) / num_parts;
+    const Index end = (cols * (part + 1)) / num_parts;
+    std::vector<bool> mask(rows, false);
+    Eigen::Matrix<Scalar,Eigen::Dynamic,1> values(rows);
+    Eigen::Matrix<Index,Eigen::Dynamic,1> indices(rows);
+    fastSparseProductColumns(lhs, rhs, begin, end, mask, values, indices,
+                             col_nnz, part_inner[part], part_data[part]);
+  }
+
+  // Concatenate the column ranges in order.
+  std::vector<Index> part_start(num_parts + 1, 0);
+  for (int part = 0; part < num_parts; ++part)
+  {
+    part_start[part + 1] = part_start[part] + Index(part_inner[part].size());
+  }
+  res.resizeNonZeros(part_start[num_parts]);
+  auto* outer = res.outerIndexPtr();
+  outer[0] = 0;
+  for (Index j=0; j<cols; ++j)
+  {
+    outer[j + 1] = outer[j] + col_nnz[j];
+  }
+#pragma omp parallel for schedule(static) num_threads(num_parts)
+  for (int part = 0; part < num_parts; ++part)
+  {
+    std::copy(part_inner[part].begin(), part_inner[part].end(), res.innerIndexPtr() + part_start[part]);
+    std::copy(part_data[part].begin(), part_data[part].end(), res.valuePtr() + part_start[part]);
+  }
+}
+
 template<typename Lhs, typename Rhs, typename ResultType>
 void fastSparseProduct(const Lhs& lhs, const Rhs& rhs, ResultType& res)
 {
@@ -75,6 +208,14 @@ void fastSparseProduct(const Lhs& lhs, const Rhs& rhs, ResultType& res)
   Index cols = rhs.outerSize();
   eigen_assert(lhs.outerSize() == rhs.innerSize());
 
+  // Large products are split into column ranges.
+  const int num_parts = detail::numPartitions(cols);
+  if (num_parts > 1)
+  {
+    fastSparseProductPartitioned(lhs, rhs, res, num_parts);
+    return;
+  }
+
   std::vector<bool> mask(rows,false);
   Eigen::Matrix<Scalar,Eigen::Dynamic,1> values(rows);
   Eigen::Matrix<Index, Eigen::Dynamic,1> indices(rows);
@@ -150,6 +291,7 @@ inline void fastDiagSparseProduct(const std::vector<double>& lhs,
 
     // Multiply rows by diagonal lhs.
     int n = res.cols();
+#pragma omp parallel for schedule(static) if(detail::numPartitions(n) > 1)
     for (int col = 0; col < n; ++col) {
         typedef Eigen::SparseMatrix<double>::InnerIterator It;
         for (It it(res, col); it; ++it) {
@@ -169,6 +311,7 @@ inline void fastSparseDiagProduct(const Eigen::SparseMatrix<double>& lhs,
 
     // Multiply columns by diagonal rhs.
     int n = res.cols();
+#pragma omp parallel for schedule(static) if(detail::numPartitions(n) > 1)
     for (int col = 0; col < n; ++col) {
         typedef Eigen::SparseMatrix<double>::InnerIterator It;
         for (It it(res, col); it; ++it) {
@@ -237,6 +380,7 @@ fastSparseAdd(Lhs& lhs, const Rhs& rhs)
         const Scalar* rhsV = rhs.valuePtr();
         Scalar* lhsV = lhs.valuePtr();
 
+#pragma omp parallel for schedule(static) if(detail::numPartitions(lhs.outerSize()) > 1)
         for(Index i=0; i<nnz; ++i )
         {
             lhsV[ i ] += rhsV[ i ];
@@ -266,6 +410,7 @@ fastSparseSubstract(Lhs& lhs, const Rhs& rhs)
         const Scalar* rhsV = rhs.valuePtr();
         Scalar* lhsV = lhs.valuePtr();
 
+#pragma omp parallel for schedule(static) if(detail::numPartitions(lhs.outerSize()) > 1)
         for(Index i=0; i<nnz; ++i )
         {
             lhsV[ i ] -= rhsV[ i ];
@@ -24,12 +24,21 @@
 #include <cmath>
 #include <iostream>
 #include <vector>
-#include <opm/core/utility/linearInterpolation.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/Exceptions.hpp>
 
 namespace Opm
 {
+    void PolymerProperties::compileTables()
+    {
+        visc_mult_table_ = c_vals_visc_.empty()
+            ? CompiledTableLinear() : CompiledTableLinear(c_vals_visc_, visc_mult_vals_);
+        ads_table_ = c_vals_ads_.empty()
+            ? CompiledTableLinear() : CompiledTableLinear(c_vals_ads_, ads_vals_);
+        shear_vrf_table_ = water_vel_vals_.empty()
+            ? CompiledTableLinear() : CompiledTableLinear(water_vel_vals_, shear_vrf_vals_);
+    }
+
     double PolymerProperties::cMax() const
     {
         return c_max_;
@@ -122,25 +131,27 @@ namespace Opm
     double
     PolymerProperties::shearVrf(const double velocity) const
     {
-        return Opm::linearInterpolation(water_vel_vals_, shear_vrf_vals_, velocity);
+        return shear_vrf_table_(velocity);
     }
 
     double
     PolymerProperties::shearVrfWithDer(const double velocity, double& der) const
     {
-        der =  Opm::linearInterpolationDerivative(water_vel_vals_, shear_vrf_vals_, velocity);
-        return Opm::linearInterpolation(water_vel_vals_, shear_vrf_vals_, velocity);
+        double vrf;
+        shear_vrf_table_.evaluate(velocity, vrf, der);
+        return vrf;
     }
 
     double PolymerProperties::viscMult(double c) const
     {
-        return Opm::linearInterpolation(c_vals_visc_, visc_mult_vals_, c);
+        return visc_mult_table_(c);
     }
 
     double PolymerProperties::viscMultWithDer(double c, double* der) const
     {
-        *der = Opm::linearInterpolationDerivative(c_vals_visc_, visc_mult_vals_, c);
-        return Opm::linearInterpolation(c_vals_visc_, visc_mult_vals_, c);
+        double visc_mult;
+        visc_mult_table_.evaluate(c, visc_mult, *der);
+        return visc_mult;
     }
 
     void PolymerProperties::simpleAdsorption(double c, double& c_ads) const
@@ -158,10 +169,8 @@ namespace Opm
     void PolymerProperties::simpleAdsorptionBoth(double c, double& c_ads,
                                                  double& dc_ads_dc, bool if_with_der) const
     {
-        c_ads = Opm::linearInterpolation(c_vals_ads_, ads_vals_, c);;
-        if (if_with_der) {
-            dc_ads_dc = Opm::linearInterpolationDerivative(c_vals_ads_, ads_vals_, c);
-        } else {
+        ads_table_.evaluate(c, c_ads, dc_ads_dc);
+        if (!if_with_der) {
             dc_ads_dc = 0.;
         }
     }
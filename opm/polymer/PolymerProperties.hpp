@@ -20,6 +20,8 @@
 #ifndef OPM_POLYMERPROPERTIES_HEADER_INCLUDED
 #define OPM_POLYMERPROPERTIES_HEADER_INCLUDED
 
+#include <opm/autodiff/CompiledTableLinear.hpp>
+
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/PlyadsTable.hpp>
@@ -90,6 +92,7 @@ namespace Opm
               water_vel_vals_(water_vel_vals),
               shear_vrf_vals_(shear_vrf_vals)
         {
+            compileTables();
         }
 
         PolymerProperties(Opm::DeckConstPtr deck, Opm::EclipseStateConstPtr eclipseState)
@@ -125,6 +128,7 @@ namespace Opm
             ads_index_ = ads_index;
             water_vel_vals_ = water_vel_vals;
             shear_vrf_vals_ = shear_vrf_vals;
+            compileTables();
         }
 
         void readFromDeck(Opm::DeckConstPtr deck, Opm::EclipseStateConstPtr eclipseState)
@@ -214,6 +218,8 @@ namespace Opm
                     has_plyshlog_ref_temp_ = false;
                 }
             }
+
+            compileTables();
         }
 
         double cMax() const;
@@ -392,6 +398,13 @@ namespace Opm
         bool has_plyshlog_ref_salinity_;
         bool has_plyshlog_ref_temp_;
 
+        // Resampled versions of the PLYVISC, PLYADS and PLYSHLOG tables
+        // above, used for the lookups.
+        CompiledTableLinear visc_mult_table_;
+        CompiledTableLinear ads_table_;
+        CompiledTableLinear shear_vrf_table_;
+
+        void compileTables();
 
         void simpleAdsorptionBoth(double c, double& c_ads,
                                   double& dc_ads_dc, bool if_with_der) const;
@@ -171,6 +171,7 @@ namespace Opm {
         using Base::use_threshold_pressure_;
         using Base::threshold_pressures_by_connection_;
         using Base::rq_;
+        using Base::upwind_;
         using Base::phaseCondition_;
         using Base::well_perforation_pressure_diffs_;
         using Base::residual_;
@@ -187,6 +188,7 @@ namespace Opm {
         using Base::computePressures;
         using Base::computeGasPressure;
         using Base::applyThresholdPressures;
+        using Base::upwindSelector;
         using Base::fluidViscosity;
         using Base::fluidReciprocFVF;
         using Base::fluidDensity;
@@ -205,6 +207,7 @@ namespace Opm {
         using Base::computeWellConnectionPressures;
         using Base::addWellControlEq;
         using Base::computeRelPerm;
+        using Base::geometryCache;
 
 
         void
@@ -226,6 +229,11 @@ namespace Opm {
         computeAccum(const SolutionState& state,
                      const int            aix  );
 
+        /// The polymer shear effects depend on the well rates, so the
+        /// transport steps use the full assembly.
+        void assembleTransportEq(const ReservoirState& reservoir_state,
+                                 WellState& well_state);
+
         void
         assembleMassBalanceEq(const SolutionState& state);
 
@@ -272,6 +272,19 @@ namespace Opm {
 
 
 
+    template <class Grid>
+    void
+    BlackoilPolymerModel<Grid>::
+    assembleTransportEq(const ReservoirState& reservoir_state,
+                        WellState& well_state)
+    {
+        assemble(reservoir_state, well_state, false);
+    }
+
+
+
+
+
     template <class Grid>
     void
     BlackoilPolymerModel<Grid>::
@@ -285,12 +298,19 @@ namespace Opm {
         // The corresponding accumulation terms from the start of
         // the timestep (b^0_p*s^0_p etc.) were already computed
         // on the initial call to assemble() and stored in rq_[phase].accum[0].
+        // The viscosities are computed together with b in Base::computeAccum().
+        for (auto& rq : rq_) {
+            rq.mu = ADB::null();
+        }
         computeAccum(state, 1);
 
         // Set up the common parts of the mass balance equations
         // for each active phase.
-        const V transi = subset(geo_.transmissibility(), ops_.internal_faces);
+        const V& transi = geometryCache().trans_all;
         const std::vector<ADB> kr = computeRelPerm(state);
+        if (upwind_.size() < rq_.size()) {
+            upwind_.resize(rq_.size());
+        }
 
 
         if (has_plyshlog_) {
@@ -306,7 +326,9 @@ namespace Opm {
 
         for (int phaseIdx = 0; phaseIdx < fluid_.numPhases(); ++phaseIdx) {
             const std::vector<PhasePresence>& cond = phaseCondition();
-            const ADB mu = fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
+            const ADB mu = rq_[phaseIdx].mu.size() > 0
+                ? rq_[phaseIdx].mu
+                : fluidViscosity(canph_[phaseIdx], state.canonical_phase_pressures[canph_[phaseIdx]], state.temperature, state.rs, state.rv, cond);
             const ADB rho = fluidDensity(canph_[phaseIdx], rq_[phaseIdx].b, state.rs, state.rv);
             computeMassFlux(phaseIdx, transi, kr[canph_[phaseIdx]], mu, rho, state.canonical_phase_pressures[canph_[phaseIdx]], state);
 
@@ -324,13 +346,8 @@ namespace Opm {
             const int po = fluid_.phaseUsage().phase_pos[ Oil ];
             const int pg = fluid_.phaseUsage().phase_pos[ Gas ];
 
-            const UpwindSelector<double> upwindOil(grid_, ops_,
-                                                rq_[po].dh.value());
-            const ADB rs_face = upwindOil.select(state.rs);
-
-            const UpwindSelector<double> upwindGas(grid_, ops_,
-                                                rq_[pg].dh.value());
-            const ADB rv_face = upwindGas.select(state.rv);
+            const ADB rs_face = upwindSelector(po, rq_[po].dh.value()).select(state.rs);
+            const ADB rv_face = upwindSelector(pg, rq_[pg].dh.value()).select(state.rv);
 
             residual_.material_balance_eq[ pg ] += ops_.div * (rs_face * rq_[po].mflux);
             residual_.material_balance_eq[ po ] += ops_.div * (rv_face * rq_[pg].mflux);
@@ -365,8 +382,8 @@ namespace Opm {
             const V polyin = Eigen::Map<const V>(xw.polymerInflow().data(), nc);
             const int nperf = wells().well_connpos[wells().number_of_wells];
             const std::vector<int> well_cells(wells().well_cells, wells().well_cells + nperf);
-            const V poly_in_perf = subset(polyin, well_cells);
-            const V poly_mc_perf = subset(mc.value(), well_cells);
+            const V poly_in_perf = wops_.c2p * polyin;
+            const V poly_mc_perf = wops_.c2p * mc.value();
             const ADB& cq_s_water = cq_s[fluid_.phaseUsage().phase_pos[Water]];
             Selector<double> injector_selector(cq_s_water.value());
             const V poly_perf = injector_selector.select(poly_in_perf, poly_mc_perf);
@@ -446,7 +463,7 @@ namespace Opm {
                 rq_[poly_pos_].mob = tr_mult * mc * krw_eff * inv_wat_eff_visc;
                 rq_[poly_pos_].b = rq_[actph].b;
                 rq_[poly_pos_].dh = rq_[actph].dh;
-                UpwindSelector<double> upwind(grid_, ops_, rq_[poly_pos_].dh.value());
+                const UpwindSelector<double>& upwind = upwindSelector(actph, rq_[poly_pos_].dh.value());
                 // Compute polymer flux.
                 rq_[poly_pos_].mflux = upwind.select(rq_[poly_pos_].b * rq_[poly_pos_].mob) * (transi * rq_[poly_pos_].dh);
                 // Must recompute water flux since we have to use modified mobilities.
@@ -513,15 +530,11 @@ namespace Opm {
         const int np = wells().number_of_phases;
         std::vector<ADB> cq_s(np, ADB::null());
 
-        const int nw = wells().number_of_wells;
-        const int nperf = wells().well_connpos[nw];
-        const std::vector<int> well_cells(wells().well_cells, wells().well_cells + nperf);
-
         std::vector<ADB> mob_perfcells(np, ADB::null());
         std::vector<ADB> b_perfcells(np, ADB::null());
         for (int phase = 0; phase < np; ++phase) {
-            mob_perfcells[phase] = subset(rq_[phase].mob, well_cells);
-            b_perfcells[phase] = subset(rq_[phase].b, well_cells);
+            mob_perfcells[phase] = wops_.c2p * rq_[phase].mob;
+            b_perfcells[phase] = wops_.c2p * rq_[phase].b;
         }
         if (param_.solve_welleq_initially_ && initial_assembly) {
             // solve the well equations as a pre-processing step
@@ -587,7 +600,7 @@ namespace Opm {
         // compute gravity potensial using the face average as in eclipse and MRST
         const ADB rho   = fluidDensity(canonicalPhaseIdx, rq_[phase].b, state.rs, state.rv);
         const ADB rhoavg = ops_.caver * rho;
-        rq_[ phase ].dh = ops_.ngrad * phasePressure[ canonicalPhaseIdx ] - geo_.gravity()[2] * (rhoavg * (ops_.ngrad * geo_.z().matrix()));
+        rq_[ phase ].dh = ops_.ngrad * phasePressure[ canonicalPhaseIdx ] - rhoavg * geometryCache().gdz;
         if (use_threshold_pressure_) {
             applyThresholdPressures(rq_[ phase ].dh);
         }
@@ -595,7 +608,7 @@ namespace Opm {
         const ADB& b   = rq_[ phase ].b;
         const ADB& mob = rq_[ phase ].mob;
         const ADB& dh  = rq_[ phase ].dh;
-        UpwindSelector<double> upwind(grid_, ops_, dh.value());
+        const UpwindSelector<double>& upwind = upwindSelector(phase, dh.value());
 
         const ADB cmax = ADB::constant(cmax_, state.concentration.blockPattern());
         const ADB mc = computeMc(state);
@@ -701,15 +714,15 @@ namespace Opm {
         const V& polymer_conc = state.concentration.value();
 
         V visc_mult_cells = polymer_props_ad_.viscMult(polymer_conc);
-        V visc_mult_wells_v = subset(visc_mult_cells, well_cells);
+        V visc_mult_wells_v = wops_.c2p * visc_mult_cells;
 
         visc_mult_wells.resize(visc_mult_wells_v.size());
         std::copy(visc_mult_wells_v.data(), visc_mult_wells_v.data() + visc_mult_wells_v.size(), visc_mult_wells.begin());
 
         const int water_pos = fluid_.phaseUsage().phase_pos[Water];
-        ADB b_perfcells = subset(rq_[water_pos].b, well_cells);
+        ADB b_perfcells = wops_.c2p * rq_[water_pos].b;
 
-        const ADB& p_perfcells = subset(state.pressure, well_cells);
+        const ADB& p_perfcells = wops_.c2p * state.pressure;
         const V& cdp = well_perforation_pressure_diffs_;
         const ADB perfpressure = (wops_.w2p * state.bhp) + cdp;
         // Pressure drawdown (also used to determine direction of flow)
@@ -731,7 +744,7 @@ namespace Opm {
         }
 
         const ADB phi = Opm::AutoDiffBlock<double>::constant(Eigen::Map<const V>(& fluid_.porosity()[0], AutoDiffGrid::numCells(grid_), 1));
-        const ADB phi_wells_adb = subset(phi, well_cells);
+        const ADB phi_wells_adb = wops_.c2p * phi;
 
         std::vector<double> phi_wells(phi_wells_adb.value().data(), phi_wells_adb.value().data() + phi_wells_adb.size());
 
@@ -421,3 +421,32 @@ BOOST_AUTO_TEST_CASE(nonZeros)
     BOOST_CHECK_EQUAL(s.nonZeros(), 4);
 }
 
+
+BOOST_AUTO_TEST_CASE(PartitionedProduct)
+{
+    // A banded matrix times a matrix with a few entries per column.
+    const int n = 1000;
+    std::vector<Eigen::Triplet<double> > ta, tb;
+    for (int i = 0; i < n; ++i) {
+        for (int k = -2; k <= 2; ++k) {
+            if (i + k >= 0 && i + k < n) {
+                ta.emplace_back(i, i + k, 1.0 + 0.01*i - 0.3*k);
+            }
+        }
+        tb.emplace_back(i, i, 2.0 - 0.001*i);
+        tb.emplace_back((7*i) % n, i, 0.5);
+    }
+    Sp a(n, n), b(n, n);
+    a.setFromTriplets(ta.begin(), ta.end());
+    b.setFromTriplets(tb.begin(), tb.end());
+
+    Sp serial;
+    fastSparseProduct(a, b, serial);
+    for (int num_parts = 1; num_parts <= 7; ++num_parts) {
+        Sp partitioned(n, n);
+        fastSparseProductPartitioned(a, b, partitioned, num_parts);
+        BOOST_CHECK(partitioned == serial);
+    }
+    const Sp eigen_product = a*b;
+    BOOST_CHECK_SMALL((eigen_product - serial).norm(), 1e-12);
+}
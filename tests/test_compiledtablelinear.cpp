@@ -0,0 +1,115 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE CompiledTableLinearTest
+
+#include <opm/autodiff/CompiledTableLinear.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Reference piecewise linear interpolation with linear extrapolation.
+    double reference(const std::vector<double>& x, const std::vector<double>& y, const double xv)
+    {
+        int i = 0;
+        while (i < int(x.size()) - 2 && x[i + 1] <= xv) {
+            ++i;
+        }
+        return y[i] + (y[i + 1] - y[i]) / (x[i + 1] - x[i]) * (xv - x[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BreakpointsOnCommonGridAreExact)
+{
+    // Breakpoints on multiples of 0.05, but not equally spaced.
+    const std::vector<double> x = { 0.1, 0.2, 0.25, 0.5, 0.9, 1.0 };
+    const std::vector<double> y = { 0.0, 0.01, 0.05, 0.2, 0.7, 1.0 };
+    const CompiledTableLinear table(x, y, 1.0e-12, CompiledTableLinear::Uniform);
+    BOOST_CHECK(table.isCompiled());
+    BOOST_CHECK_EQUAL(table.spacing(), CompiledTableLinear::Uniform);
+    BOOST_CHECK_EQUAL(table.numPoints(), 19);
+    for (int k = 0; k <= 200; ++k) {
+        const double xv = 0.05 + 0.005 * k;
+        BOOST_CHECK_SMALL(table(xv) - reference(x, y, xv), 1.0e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ErrorBoundIsRespected)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 13; ++i) {
+        const double xi = 1.0e5 * std::pow(1.7, i) + 3.0e3 * i;
+        x.push_back(xi);
+        y.push_back(1.0 / (1.0 + 1.0e-8 * xi));
+    }
+    const double tol = 1.0e-4;
+    const CompiledTableLinear table(x, y, tol);
+    BOOST_REQUIRE(table.isCompiled());
+    BOOST_CHECK(table.maxError() <= tol);
+    for (int k = 0; k <= 1000; ++k) {
+        const double xv = x.front() + (x.back() - x.front()) * k / 1000.0;
+        BOOST_CHECK(std::abs(table(xv) - reference(x, y, xv)) <= tol);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LogarithmicGridForGeometricTable)
+{
+    std::vector<double> x, y;
+    for (int i = 0; i < 9; ++i) {
+        x.push_back(std::pow(10.0, i - 4));
+        y.push_back(1.0 - 0.1 * i * i / 64.0);
+    }
+    const CompiledTableLinear table(x, y, 1.0e-10);
+    BOOST_REQUIRE(table.isCompiled());
+    BOOST_CHECK_EQUAL(table.spacing(), CompiledTableLinear::Logarithmic);
+    BOOST_CHECK_EQUAL(table.numPoints(), 9);
+    for (int i = 0; i < 9; ++i) {
+        BOOST_CHECK_CLOSE(table(x[i]), y[i], 1.0e-8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FallbackAndExtrapolation)
+{
+    // A kink that cannot be resolved with few points.
+    const std::vector<double> x = { 0.0, 0.3333333, 1.0 };
+    const std::vector<double> y = { 0.0, 0.0, 1.0 };
+    const CompiledTableLinear table(x, y, 1.0e-12, CompiledTableLinear::Uniform, 64);
+    BOOST_CHECK(!table.isCompiled());
+    BOOST_CHECK_SMALL(table(0.2), 1.0e-14);
+    BOOST_CHECK_CLOSE(table(0.5), reference(x, y, 0.5), 1.0e-12);
+    BOOST_CHECK_CLOSE(table.derivative(0.5), 1.5, 1.0e-5);
+
+    // Linear extrapolation of the end intervals.
+    BOOST_CHECK_SMALL(table(-1.0), 1.0e-14);
+    BOOST_CHECK_CLOSE(table(2.0), reference(x, y, 2.0), 1.0e-12);
+    BOOST_CHECK_CLOSE(table.derivative(2.0), 1.5, 1.0e-5);
+}
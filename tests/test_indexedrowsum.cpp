@@ -0,0 +1,138 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE IndexedRowSumTest
+
+#include <opm/autodiff/IndexedRowSum.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace Opm;
+
+typedef AutoDiffBlock<double> ADB;
+typedef ADB::V V;
+typedef ADB::M M;
+
+namespace
+{
+    Eigen::SparseMatrix<double> toSparseMatrix(const int cols,
+                                               const std::vector<int>& starts,
+                                               const std::vector<int>& sources)
+    {
+        typedef Eigen::Triplet<double> Tri;
+        std::vector<Tri> t;
+        for (int i = 0; i + 1 < int(starts.size()); ++i) {
+            for (int k = starts[i]; k < starts[i + 1]; ++k) {
+                t.push_back(Tri(i, sources[k], 1.0));
+            }
+        }
+        Eigen::SparseMatrix<double> s(starts.size() - 1, cols);
+        s.setFromTriplets(t.begin(), t.end());
+        return s;
+    }
+
+    void checkEqual(const M& a, const M& b)
+    {
+        BOOST_REQUIRE_EQUAL(a.rows(), b.rows());
+        BOOST_REQUIRE_EQUAL(a.cols(), b.cols());
+        Eigen::SparseMatrix<double> as, bs;
+        a.toSparse(as);
+        b.toSparse(bs);
+        BOOST_CHECK_SMALL(Eigen::MatrixXd(as - bs).norm(), 1e-14);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MatchesSparseProduct)
+{
+    // Sums of several entries, a gather, and an empty row.
+    const std::vector<int> starts = { 0, 2, 3, 3, 6 };
+    const std::vector<int> sources = { 0, 3, 1, 4, 2, 0 };
+    const IndexedRowSum op(5, starts, sources);
+    const Eigen::SparseMatrix<double> s = toSparseMatrix(5, starts, sources);
+    BOOST_CHECK_EQUAL(op.rows(), 4);
+    BOOST_CHECK_EQUAL(op.cols(), 5);
+
+    V x0(5);
+    x0 << 1.0, 2.0, 3.0, 4.0, 5.0;
+    V y0(3);
+    y0 << 0.5, 1.5, 2.5;
+    std::vector<V> vals = { x0, y0 };
+    std::vector<ADB> vars = ADB::variables(vals);
+    // Jacobian blocks that are sparse, diagonal, identity and zero.
+    const Eigen::SparseMatrix<double> mix = toSparseMatrix(5, { 0, 2, 3, 5, 6, 7 }, { 0, 1, 2, 3, 4, 0, 2 });
+    const ADB x = mix * vars[0];
+    const ADB y = vars[0] * vars[0];
+
+    const std::vector<const ADB*> args = { &x, &y, &vars[0] };
+    for (const ADB* a : args) {
+        const ADB result = op * (*a);
+        const ADB expected = s * (*a);
+        BOOST_CHECK_SMALL((result.value() - expected.value()).matrix().norm(), 1e-14);
+        BOOST_REQUIRE_EQUAL(result.numBlocks(), expected.numBlocks());
+        for (int b = 0; b < result.numBlocks(); ++b) {
+            checkEqual(result.derivative()[b], expected.derivative()[b]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedSources)
+{
+    // An entry summed twice in one row, and in several rows.
+    const std::vector<int> starts = { 0, 3, 4, 6 };
+    const std::vector<int> sources = { 1, 0, 1, 1, 2, 2 };
+    const IndexedRowSum op(3, starts, sources);
+    const Eigen::SparseMatrix<double> s = toSparseMatrix(3, starts, sources);
+
+    V x0(3);
+    x0 << 1.0, 2.0, 3.0;
+    const ADB x = ADB::variable(0, x0, { 3 });
+    const ADB y = x * x;
+    const ADB z = toSparseMatrix(3, { 0, 2, 3, 4 }, { 1, 2, 0, 1 }) * x;
+
+    const std::vector<const ADB*> args = { &x, &y, &z };
+    for (const ADB* a : args) {
+        const ADB result = op * (*a);
+        const ADB expected = s * (*a);
+        BOOST_CHECK_SMALL((result.value() - expected.value()).matrix().norm(), 1e-14);
+        checkEqual(result.derivative()[0], expected.derivative()[0]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Gather)
+{
+    const std::vector<int> index = { 2, -1, 0, 2 };
+    const IndexedRowSum op = IndexedRowSum::gather(3, index);
+    V x(3);
+    x << 1.0, 2.0, 3.0;
+    const V y = op * x;
+    BOOST_REQUIRE_EQUAL(y.size(), 4);
+    BOOST_CHECK_EQUAL(y[0], 3.0);
+    BOOST_CHECK_EQUAL(y[1], 0.0);
+    BOOST_CHECK_EQUAL(y[2], 1.0);
+    BOOST_CHECK_EQUAL(y[3], 3.0);
+}
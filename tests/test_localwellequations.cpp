@@ -0,0 +1,135 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE LocalWellEquationsTest
+
+#include <opm/autodiff/LocalWellEquations.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Three-phase well with two perforations, ordered water, oil, gas.
+    LocalWellEquations makeWell(const bool injector)
+    {
+        const std::vector<double> comp_frac = injector
+            ? std::vector<double>{ 1.0, 0.0, 0.0 }
+            : std::vector<double>{ 0.0, 0.0, 0.0 };
+        LocalWellEquations well(3, 1, 2, injector, true, comp_frac);
+        const double mob1[] = { 1.0e3, 2.0e3, 5.0e3 };
+        const double b1[] = { 1.0, 0.8, 50.0 };
+        const double mob2[] = { 2.0e3, 1.0e3, 4.0e3 };
+        const double b2[] = { 1.0, 0.85, 60.0 };
+        well.addPerforation(1.0e-12, 2.0e7, 0.0, 50.0, 1.0e-4, mob1, b1);
+        well.addPerforation(2.0e-12, 2.1e7, 5.0e4, 60.0, 2.0e-4, mob2, b2);
+        return well;
+    }
+
+    LocalWellEquations::Vector solve(const LocalWellEquations& well, LocalWellEquations::Vector x)
+    {
+        LocalWellEquations::Vector res;
+        LocalWellEquations::Matrix jac;
+        std::vector<double> perf_rates;
+        for (int it = 0; it < 20; ++it) {
+            well.linearise(x, res, jac, perf_rates);
+            x -= jac.partialPivLu().solve(res);
+        }
+        return x;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(JacobianMatchesDifferences)
+{
+    const LocalWellEquations well = makeWell(false);
+    LocalWellEquations::Vector x(4);
+    x << -1.0e-3, -2.0e-3, -0.1, 1.5e7;
+
+    LocalWellEquations::Vector res;
+    LocalWellEquations::Matrix jac;
+    std::vector<double> perf_rates;
+    well.linearise(x, res, jac, perf_rates);
+    BOOST_CHECK_EQUAL(perf_rates.size(), 6u);
+
+    for (int col = 0; col < 4; ++col) {
+        const double h = 1.0e-6 * std::max(std::abs(x[col]), 1.0);
+        LocalWellEquations::Vector xp = x;
+        xp[col] += h;
+        LocalWellEquations::Vector resp;
+        LocalWellEquations::Matrix jacp;
+        well.linearise(xp, resp, jacp, perf_rates);
+        for (int row = 0; row < 4; ++row) {
+            const double fd = (resp[row] - res[row]) / h;
+            BOOST_CHECK_SMALL(fd - jac(row, col), 1.0e-6 * std::max(std::abs(jac(row, col)), 1.0e-12));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ProducerUnderBhpControl)
+{
+    LocalWellEquations well = makeWell(false);
+    well.setControl(LocalWellEquations::Bhp, 1.5e7, 0);
+    LocalWellEquations::Vector x = LocalWellEquations::Vector::Zero(4);
+    x[3] = 1.8e7;
+    x = solve(well, x);
+
+    LocalWellEquations::Vector res;
+    LocalWellEquations::Matrix jac;
+    std::vector<double> perf_rates;
+    well.linearise(x, res, jac, perf_rates);
+    BOOST_CHECK_CLOSE(x[3], 1.5e7, 1.0e-10);
+    for (int phase = 0; phase < 3; ++phase) {
+        BOOST_CHECK(x[phase] < 0.0);
+        BOOST_CHECK_CLOSE(x[phase], perf_rates[phase] + perf_rates[3 + phase], 1.0e-8);
+        BOOST_CHECK_SMALL(res[phase], 1.0e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(InjectorUnderRateControl)
+{
+    LocalWellEquations well = makeWell(true);
+    const double distr[] = { 1.0, 0.0, 0.0 };
+    well.setControl(LocalWellEquations::Rate, 1.0e-3, distr);
+    LocalWellEquations::Vector x = LocalWellEquations::Vector::Zero(4);
+    x[0] = 1.0e-3;
+    x[3] = 2.5e7;
+    x = solve(well, x);
+
+    LocalWellEquations::Vector res;
+    LocalWellEquations::Matrix jac;
+    std::vector<double> perf_rates;
+    well.linearise(x, res, jac, perf_rates);
+    BOOST_CHECK_CLOSE(x[0], 1.0e-3, 1.0e-8);
+    BOOST_CHECK(x[3] > 2.0e7);
+    for (int i = 0; i < 4; ++i) {
+        BOOST_CHECK_SMALL(res[i], 1.0e-12);
+    }
+}
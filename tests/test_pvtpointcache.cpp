@@ -0,0 +1,81 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE PvtPointCacheTest
+
+#include <opm/autodiff/PvtPointCache.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace Opm;
+
+BOOST_AUTO_TEST_CASE(EmptyCacheMisses)
+{
+    PvtPointCache cache;
+    cache.reset(3);
+    BOOST_CHECK_EQUAL(cache.size(), 3);
+    double value = -1.0, dp = -1.0, dr = -1.0;
+    BOOST_CHECK(!cache.lookup(1, 1.0e7, 300.0, 50.0, false, 1.0e-3, value, dp, dr));
+    BOOST_CHECK_EQUAL(value, -1.0);
+}
+
+BOOST_AUTO_TEST_CASE(HitIsFirstOrderExtrapolation)
+{
+    PvtPointCache cache;
+    cache.reset(2);
+    cache.store(0, 1.0e7, 300.0, 50.0, false, 1.2, 1.0e-8, 2.0e-3);
+
+    double value, dp, dr;
+    BOOST_REQUIRE(cache.lookup(0, 1.0e7 + 100.0, 300.0, 50.01, false, 1.0e-3, value, dp, dr));
+    BOOST_CHECK_CLOSE(value, 1.2 + 1.0e-8*100.0 + 2.0e-3*0.01, 1.0e-10);
+    BOOST_CHECK_EQUAL(dp, 1.0e-8);
+    BOOST_CHECK_EQUAL(dr, 2.0e-3);
+
+    // Other cells are unaffected.
+    BOOST_CHECK(!cache.lookup(1, 1.0e7, 300.0, 50.0, false, 1.0e-3, value, dp, dr));
+}
+
+BOOST_AUTO_TEST_CASE(MissOutsideToleranceOrOnBranchChange)
+{
+    PvtPointCache cache;
+    cache.reset(1);
+    cache.store(0, 1.0e7, 300.0, 50.0, false, 1.2, 1.0e-8, 2.0e-3);
+
+    double value, dp, dr;
+    BOOST_CHECK(!cache.lookup(0, 1.1e7, 300.0, 50.0, false, 1.0e-3, value, dp, dr));
+    BOOST_CHECK(!cache.lookup(0, 1.0e7, 310.0, 50.0, false, 1.0e-3, value, dp, dr));
+    BOOST_CHECK(!cache.lookup(0, 1.0e7, 300.0, 55.0, false, 1.0e-3, value, dp, dr));
+    BOOST_CHECK(!cache.lookup(0, 1.0e7, 300.0, 50.0, true, 1.0e-3, value, dp, dr));
+
+    // A zero tolerance still reuses exactly repeated evaluations.
+    BOOST_CHECK(cache.lookup(0, 1.0e7, 300.0, 50.0, false, 0.0, value, dp, dr));
+    BOOST_CHECK_EQUAL(value, 1.2);
+
+    // The saturated branch ignores r.
+    cache.store(0, 1.0e7, 300.0, 50.0, true, 1.3, 1.0e-8, 0.0);
+    BOOST_CHECK(cache.lookup(0, 1.0e7, 300.0, 80.0, true, 1.0e-3, value, dp, dr));
+    BOOST_CHECK_EQUAL(value, 1.3);
+}
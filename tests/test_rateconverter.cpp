@@ -122,3 +122,29 @@ BOOST_FIXTURE_TEST_CASE(ThreePhase, TestFixture<SetupSimple>)
     BOOST_CHECK_CLOSE(coeff[1], 1.0, 1.0e-6);
     BOOST_CHECK_CLOSE(coeff[2], 1.0, 1.0e-6);
 }
+
+
+BOOST_FIXTURE_TEST_CASE(ThreePhaseRegionSubset, TestFixture<SetupSimple>)
+{
+    typedef std::vector<int>                     Region;
+    typedef Opm::BlackoilPropsAdFromDeck         Props;
+    typedef Opm::RateConverter::
+        SurfaceToReservoirVoidage<Props, Region> RCvrt;
+
+    Region reg{ 0 };
+    RCvrt  cvrt(ad_props, reg);
+
+    Opm::BlackoilState x( Opm::UgGridHelpers::numCells( *grid.c_grid()) , Opm::UgGridHelpers::numFaces( *grid.c_grid()) , 3);
+
+    // Only define the state in the region hosting the wells.
+    const std::vector<RCvrt::RegionId> regions{ 0 };
+    cvrt.defineState(x, boost::any(), regions);
+
+    std::vector<double> qs{1.0e3, 1.0e1, 1.0e-1};
+    std::vector<double> coeff(qs.size(), 0.0);
+
+    cvrt.calcCoeff(qs, 0, coeff);
+    BOOST_CHECK_CLOSE(coeff[0], 1.0, 1.0e-6);
+    BOOST_CHECK_CLOSE(coeff[1], 1.0, 1.0e-6);
+    BOOST_CHECK_CLOSE(coeff[2], 1.0, 1.0e-6);
+}
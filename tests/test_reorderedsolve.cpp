@@ -0,0 +1,112 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE ReorderedSolveTest
+
+#include <opm/autodiff/NewtonIterationUtilities.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+using namespace Opm;
+
+namespace {
+    typedef AutoDiffBlock<double>::V V;
+    typedef Eigen::SparseMatrix<double, Eigen::RowMajor> RowMat;
+
+    // Two unknowns per cell on a 1D chain of cells. Every cell depends on
+    // its upstream neighbour, and with backflow also on its downstream
+    // neighbour in every fourth cell, which creates cycles.
+    RowMat chainSystem(const int nc, const bool backflow)
+    {
+        const int nv = 2;
+        std::vector< Eigen::Triplet<double> > t;
+        for (int v = 0; v < nv; ++v) {
+            for (int w = 0; w < nv; ++w) {
+                for (int c = 0; c < nc; ++c) {
+                    t.emplace_back(v*nc + c, w*nc + c, (v == w ? 4.0 : 0.5) + 0.01*c);
+                    if (c > 0) {
+                        t.emplace_back(v*nc + c, w*nc + c - 1, -1.0 - 0.1*v);
+                    }
+                    if (backflow && c % 4 == 1 && c + 1 < nc) {
+                        t.emplace_back(v*nc + c, w*nc + c + 1, -0.3);
+                    }
+                }
+            }
+        }
+        RowMat A(nv*nc, nv*nc);
+        A.setFromTriplets(t.begin(), t.end());
+        return A;
+    }
+
+    void checkSolution(const RowMat& A, const int nc)
+    {
+        V b(A.rows());
+        for (int i = 0; i < b.size(); ++i) {
+            b[i] = 1.0 + 0.1*i;
+        }
+        const V x = solveReorderedSystem(A, b, nc);
+        const Eigen::VectorXd r = A*x.matrix() - b.matrix();
+        BOOST_CHECK_SMALL(r.lpNorm<Eigen::Infinity>(), 1.0e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(TriangularSystem)
+{
+    const int nc = 20;
+    checkSolution(chainSystem(nc, false), nc);
+}
+
+BOOST_AUTO_TEST_CASE(SystemWithCycles)
+{
+    const int nc = 21;
+    checkSolution(chainSystem(nc, true), nc);
+}
+
+BOOST_AUTO_TEST_CASE(InconsistentSizes)
+{
+    RowMat A(5, 5);
+    V b = V::Zero(5);
+    BOOST_CHECK_THROW(solveReorderedSystem(A, b, 2), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(SingularBlock)
+{
+    // The equations of the second cell do not depend on its unknowns.
+    const int nc = 3;
+    std::vector< Eigen::Triplet<double> > t;
+    for (int c = 0; c < nc; ++c) {
+        if (c != 1) {
+            t.emplace_back(c, c, 1.0);
+        }
+    }
+    RowMat A(nc, nc);
+    A.setFromTriplets(t.begin(), t.end());
+    V b = V::Ones(nc);
+    BOOST_CHECK_THROW(solveReorderedSystem(A, b, nc), LinearSolverProblem);
+}
@@ -0,0 +1,103 @@
+/*
+  Copyright 2016 SINTEF ICT, Applied Mathematics.
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <config.h>
+
+#if HAVE_DYNAMIC_BOOST_TEST
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#define BOOST_TEST_MODULE SegmentTreeSolverTest
+
+#include <opm/autodiff/SegmentTreeSolver.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Opm;
+
+namespace
+{
+    // Fill the solver and a dense copy of the same system with
+    // "random" blocks, with dominant diagonal blocks.
+    Eigen::MatrixXd fillSystem(SegmentTreeSolver& solver, const std::vector<int>& outlet)
+    {
+        const int nseg = solver.numSegments();
+        const int bs = solver.blockSize();
+        Eigen::MatrixXd dense = Eigen::MatrixXd::Zero(nseg*bs, nseg*bs);
+        unsigned long randx = 42;
+        auto next = [&randx]() {
+            randx = (randx*1103515245 + 12345) % 2147483648ul;
+            return randx / 2147483648.0 - 0.5;
+        };
+        for (int seg = 0; seg < nseg; ++seg) {
+            for (int i = 0; i < bs; ++i) {
+                for (int j = 0; j < bs; ++j) {
+                    solver.diagonal(seg)(i, j) = next() + (i == j ? 4.0 : 0.0);
+                    if (outlet[seg] >= 0) {
+                        solver.toOutlet(seg)(i, j) = next();
+                        solver.fromOutlet(seg)(i, j) = next();
+                    }
+                }
+            }
+            dense.block(seg*bs, seg*bs, bs, bs) = solver.diagonal(seg);
+            if (outlet[seg] >= 0) {
+                dense.block(seg*bs, outlet[seg]*bs, bs, bs) = solver.toOutlet(seg);
+                dense.block(outlet[seg]*bs, seg*bs, bs, bs) = solver.fromOutlet(seg);
+            }
+        }
+        return dense;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MatchesDenseSolve)
+{
+    // Two wells: a branched one with segments not ordered by
+    // their outlets, and a single-segment one.
+    const std::vector<int> outlet = { -1, 0, 1, 1, 5, 0, 3, -1 };
+    SegmentTreeSolver solver(outlet, 4);
+    const Eigen::MatrixXd dense = fillSystem(solver, outlet);
+    solver.factorize();
+
+    const int n = dense.rows();
+    Eigen::MatrixXd rhs(n, 3);
+    for (int i = 0; i < n; ++i) {
+        rhs(i, 0) = 1.0;
+        rhs(i, 1) = i;
+        rhs(i, 2) = (i % 3) - 1.0;
+    }
+    const Eigen::MatrixXd ref = dense.partialPivLu().solve(rhs);
+
+    Eigen::MatrixXd x = rhs;
+    solver.solve(x);
+    BOOST_CHECK_SMALL((x - ref).norm(), 1.0e-12 * ref.norm());
+
+    Eigen::VectorXd v = rhs.col(1);
+    solver.solve(v);
+    BOOST_CHECK_SMALL((v - ref.col(1)).norm(), 1.0e-12 * ref.norm());
+}
+
+BOOST_AUTO_TEST_CASE(RejectsCycles)
+{
+    const std::vector<int> outlet = { -1, 2, 1 };
+    BOOST_CHECK_THROW(SegmentTreeSolver(outlet, 2), std::logic_error);
+}
@@ -108,6 +108,25 @@ BOOST_AUTO_TEST_CASE(findInterpData)
     BOOST_CHECK_EQUAL(eval5.factor_, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(findInterpDataBracket)
+{
+    std::vector<double> values = {1, 5, 7, 9, 11, 15};
+
+    //Any starting interval must give the same result as a full search
+    for (int start = -2; start < 8; ++start) {
+        for (double value = -1.0; value <= 19.0; value += 0.5) {
+            int bracket = start;
+            Opm::detail::InterpData eval = Opm::detail::findInterpData(value, values, bracket);
+            Opm::detail::InterpData ref = Opm::detail::findInterpData(value, values);
+
+            BOOST_CHECK_EQUAL(eval.ind_[0], ref.ind_[0]);
+            BOOST_CHECK_EQUAL(eval.ind_[1], ref.ind_[1]);
+            BOOST_CHECK_EQUAL(eval.factor_, ref.factor_);
+            BOOST_CHECK_EQUAL(bracket, ref.ind_[0]);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperTests
 
 
@@ -982,6 +1001,83 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+BOOST_AUTO_TEST_CASE(FLOToBHPAndBackPlane)
+{
+    fillDataPlane();
+    initProperties();
+
+    double aqua = -0.5;
+    double liquid = -0.9;
+    double vapour = -0.1;
+    double thp = 0.5;
+    double alq = 0.25;
+
+    //FLO_OIL, WFR_WOR and GFR_GOR
+    double wfr = aqua / liquid;
+    double gfr = vapour / liquid;
+
+    double bhp_val = properties->bhp(1, aqua, liquid, vapour, thp, alq);
+    double flo_val = properties->flo(1, bhp_val, thp, wfr, gfr, alq);
+
+    BOOST_CHECK_CLOSE(flo_val, -liquid, max_d_tol);
+
+    //Extrapolation beyond the largest rate
+    liquid = -1.5;
+    wfr = aqua / liquid;
+    gfr = vapour / liquid;
+    bhp_val = properties->bhp(1, aqua, liquid, vapour, thp, alq);
+    flo_val = properties->flo(1, bhp_val, thp, wfr, gfr, alq);
+
+    BOOST_CHECK_CLOSE(flo_val, -liquid, max_d_tol);
+
+    //No flow if the bhp is below that of zero rate
+    flo_val = properties->flo(1, -10.0, thp, wfr, gfr, alq);
+    BOOST_CHECK_EQUAL(flo_val, 0.0);
+}
+
+
+
+
+BOOST_AUTO_TEST_CASE(RateScalingPlane)
+{
+    fillDataPlane();
+    initProperties();
+
+    double aqua = -0.5;
+    double liquid = -0.9;
+    double vapour = -0.1;
+    double thp = 0.5;
+    double alq = 0.25;
+
+    //Same phase fractions, twice the rates
+    double bhp_val = properties->bhp(1, 2.0*aqua, 2.0*liquid, 2.0*vapour, thp, alq);
+    double scale = properties->rateScaling(1, aqua, liquid, vapour, bhp_val, thp, alq);
+
+    BOOST_CHECK_CLOSE(scale, 2.0, max_d_tol);
+
+    //No scaling of rates that are not produced
+    scale = properties->rateScaling(1, -aqua, -liquid, -vapour, bhp_val, thp, alq);
+    BOOST_CHECK_EQUAL(scale, 0.0);
+}
+
+
+
+BOOST_AUTO_TEST_CASE(findFlo)
+{
+    std::vector<double> flo = {0, 1, 2, 3, 4};
+    //Hydrostatic head dominates at low rates, friction at high rates
+    std::vector<double> bhp = {10, 8, 7, 9, 13};
+
+    //The root at the highest rate is used
+    BOOST_CHECK_CLOSE(Opm::detail::findFlo(bhp, flo, 9.0), 3.0, max_d_tol);
+    BOOST_CHECK_CLOSE(Opm::detail::findFlo(bhp, flo, 8.0), 2.5, max_d_tol);
+    BOOST_CHECK_CLOSE(Opm::detail::findFlo(bhp, flo, 12.0), 3.75, max_d_tol);
+    BOOST_CHECK_CLOSE(Opm::detail::findFlo(bhp, flo, 20.0), 5.75, max_d_tol);
+    BOOST_CHECK_EQUAL(Opm::detail::findFlo(bhp, flo, 6.0), 0.0);
+}
+
+
+
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
 